@@ -0,0 +1,71 @@
+#include <gamekid/batch/batch_runner.h>
+#include <gamekid/utils/convert.h>
+#include <gamekid/utils/files.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using gamekid::batch::batch_job;
+using gamekid::batch::batch_result;
+using gamekid::batch::batch_runner;
+
+// gamekid.batch <jobs file> [threads]
+// gamekid.batch instances <rom> <count> <frames> [threads]
+//
+// Runs the jobs headless on every core and writes a line for every job as it ends:
+// job, worker, frames, milliseconds, screen hash, state hash and the error (empty if it ran to its end)
+int main(const int argc, const char* argv[]) {
+    std::vector<batch_job> jobs;
+    gamekid::batch::batch_options options;
+    int threads_argument;
+
+    try {
+        if (argc >= 5 && std::string(argv[1]) == "instances") {
+            const batch_job job{ argv[2], "", static_cast<dword>(std::stoul(argv[4])) };
+            jobs = batch_runner::instances(job, std::stoul(argv[3]));
+            threads_argument = 5;
+        } else if (argc >= 2) {
+            const std::vector<byte> text = gamekid::utils::files::read_file(argv[1]);
+            jobs = batch_runner::parse_jobs(std::string(text.begin(), text.end()));
+            threads_argument = 2;
+        } else {
+            std::cerr << "Usage: gamekid.batch <jobs file> [threads]" << std::endl
+                << "       gamekid.batch instances <rom> <count> <frames> [threads]" << std::endl;
+            return -1;
+        }
+
+        if (argc > threads_argument) {
+            options.threads = std::stoul(argv[threads_argument]);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+
+    batch_runner batch(options);
+    std::cerr << jobs.size() << " jobs on " << batch.threads() << " threads" << std::endl;
+    std::cout << "job\tworker\tframes\tms\tscreen\tstate\terror" << std::endl;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::uint64_t frames = 0;
+    size_t failed = 0;
+
+    batch.run(jobs, [&frames, &failed](const batch_result& result) {
+        using gamekid::utils::convert::to_hex;
+        frames += result.frames;
+        failed += result.error.empty() ? 0 : 1;
+
+        // a line at a time, a reader of the stream sees the jobs as they end
+        std::cout << result.job << '\t' << result.worker << '\t' << result.frames << '\t' << result.milliseconds << '\t'
+            << to_hex(static_cast<dword>(result.screen >> 32)) << to_hex(static_cast<dword>(result.screen)) << '\t'
+            << to_hex(static_cast<dword>(result.state >> 32)) << to_hex(static_cast<dword>(result.state)) << '\t'
+            << result.error << std::endl;
+    });
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cerr << frames << " frames in " << elapsed.count() << "s, " << frames / elapsed.count() << " frames/s, "
+        << failed << " failed" << std::endl;
+
+    return failed == 0 ? 0 : 1;
+}
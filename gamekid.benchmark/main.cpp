@@ -0,0 +1,108 @@
+#include <gamekid/io/video/lcd.h>
+#include <gamekid/io/video/lcd_timing.h>
+#include <gamekid/io/audio/apu.h>
+#include <gamekid/io/audio/audio_timing.h>
+#include <gamekid/io/io_registers.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace gamekid::io::video;
+
+// Busy frames: random looking tiles, a window, ten sprites on every line and scroll writes every few cycles
+double time_frames(renderer_type type, dword frames) {
+    lcd lcd(render_mode::scanline, type);
+
+    for (word i = 0; i < vram_size; ++i) {
+        lcd.store(0x8000 + i, static_cast<byte>(i * 13 + (i >> 5)));
+    }
+
+    for (byte i = 0; i < oam_size / 4; ++i) {
+        lcd.store(0xFE00 + i * 4, 16 + (i % 18) * 8);
+        lcd.store(0xFE00 + i * 4 + 1, 8 + i * 4);
+        lcd.store(0xFE00 + i * 4 + 2, i);
+        lcd.store(0xFE00 + i * 4 + 3, (i & 1) ? 0x90 : 0x00);
+    }
+
+    lcd.store(BGP, 0xE4);
+    lcd.store(OBP0, 0xD2);
+    lcd.store(WY, 72);
+    lcd.store(WX, 80);
+    lcd.enabled(true);
+    lcd.store(LCDC, 0xF3);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (dword cycle = 0; cycle < lcd_timing::cycles_per_frame * frames; cycle += 16) {
+        lcd.store(SCX, static_cast<byte>(cycle / 64));
+        lcd.tick(16);
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / frames;
+}
+
+// Both squares, the wave and the noise channel playing notes that change every millisecond
+double time_audio(gamekid::io::audio::synthesis mode, dword seconds) {
+    using namespace gamekid::io::audio;
+    apu apu(mode);
+
+    for (word i = 0; i < 16; ++i) {
+        apu.store(0xFF30 + i, static_cast<byte>(i * 0x11));
+    }
+
+    apu.store(NR_52, 0x80);
+    apu.store(NR_50, 0x77);
+    apu.store(NR_51, 0xFF);
+    apu.store(NR_11, 0x80);
+    apu.store(NR_12, 0xF0);
+    apu.store(NR_21, 0x40);
+    apu.store(NR_22, 0xC0);
+    apu.store(NR_30, 0x80);
+    apu.store(NR_32, 0x40);
+    apu.store(NR_42, 0xA0);
+    apu.store(NR_43, 0x21);
+    apu.store(NR_44, 0x80);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (dword ms = 0; ms < seconds * 1000; ++ms) {
+        apu.store(NR_13, static_cast<byte>(ms * 7));
+        apu.store(NR_14, 0x86);
+        apu.store(NR_23, static_cast<byte>(ms * 13));
+        apu.store(NR_24, 0x85);
+        apu.store(NR_34, 0x86);
+        apu.tick(audio_timing::cycles_per_second / 1000);
+
+        // the samples are consumed every frame
+        if (apu.samples().size() > audio_timing::sample_rate / 30) apu.clear_samples();
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / seconds;
+}
+
+int main(int argc, const char** argv) {
+    const dword frames = argc > 1 ? std::atoi(argv[1]) : 600;
+
+    const double per_line = time_frames(renderer_type::per_line, frames);
+    const double pixel_fifo = time_frames(renderer_type::pixel_fifo, frames);
+
+    std::cout << "frames:     " << frames << std::endl;
+    std::cout << "per_line:   " << per_line << " ms/frame" << std::endl;
+    std::cout << "pixel_fifo: " << pixel_fifo << " ms/frame" << std::endl;
+    std::cout << "ratio:      " << pixel_fifo / per_line << "x" << std::endl;
+
+    const dword seconds = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    const double band_limited = time_audio(gamekid::io::audio::synthesis::band_limited, seconds);
+    const double oversampled = time_audio(gamekid::io::audio::synthesis::oversampled, seconds);
+
+    std::cout << std::endl << "audio seconds: " << seconds << std::endl;
+    std::cout << "band_limited:  " << band_limited << " ms/second" << std::endl;
+    std::cout << "oversampled:   " << oversampled << " ms/second (4x)" << std::endl;
+    std::cout << "ratio:         " << oversampled / band_limited << "x" << std::endl;
+
+    return 0;
+}
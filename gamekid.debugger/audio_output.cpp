@@ -0,0 +1,61 @@
+#include "audio_output.h"
+#include <gamekid/io/audio/audio_timing.h>
+#include <SDL2/SDL.h>
+#include <chrono>
+#include <thread>
+
+using namespace gamekid::io::audio;
+
+namespace gamekid::debugger {
+
+    // about 512 samples are asked for at a time, the buffer holds ~85ms and is kept half full
+    const Uint16 device_samples = 512;
+    const size_t buffer_frames = 4096;
+
+    audio_output::audio_subsystem::audio_subsystem() {
+        SDL_InitSubSystem(SDL_INIT_AUDIO);
+    }
+
+    audio_output::audio_subsystem::~audio_subsystem() {
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    }
+
+    audio_output::audio_output() :
+        _buffer(buffer_frames),
+        _device(SDL2pp::NullOpt, false,
+            SDL2pp::AudioSpec(audio_timing::sample_rate, AUDIO_S16SYS, audio_timing::output_channels, device_samples),
+            [this](Uint8* stream, int length) {
+                _buffer.pop(reinterpret_cast<sample*>(stream), length / sizeof(sample));
+            }) {
+        _device.Pause(false);
+    }
+
+    audio_output::~audio_output() {
+        _device.Pause(true);
+    }
+
+    void audio_output::push(apu& apu) {
+        apu.flush();
+
+        const audio_telemetry telemetry = _buffer.telemetry();
+        const double ratio = dynamic_ratio(telemetry.fill, telemetry.capacity);
+
+        _resampled.clear();
+        _resampler.process(apu.samples().data(), apu.samples().size() / audio_timing::output_channels, ratio, _resampled);
+        _buffer.push(_resampled.data(), _resampled.size());
+        apu.clear_samples();
+    }
+
+    void audio_output::wait() const {
+        // a frame of samples
+        const size_t slack = audio_timing::sample_rate * io::video::lcd_timing::cycles_per_frame / audio_timing::cycles_per_second;
+
+        while (_buffer.telemetry().fill > buffer_frames / 2 + slack) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    audio_telemetry audio_output::telemetry() const {
+        return _buffer.telemetry();
+    }
+}
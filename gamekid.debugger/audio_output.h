@@ -0,0 +1,41 @@
+#pragma once
+#include <SDL2pp/SDL2pp.hh>
+#include <gamekid/io/audio/apu.h>
+#include <gamekid/io/audio/audio_buffer.h>
+#include <gamekid/io/audio/resampler.h>
+
+namespace gamekid::debugger {
+
+    // Plays the apu samples on the default audio device.
+    // The emulation thread pushes, the SDL callback pops, they only share the lock free buffer.
+    // The samples are resampled by up to 0.5% to keep the buffer half full, so the emulation
+    // can follow the audio clock (wait) instead of the display's refresh rate.
+    class audio_output {
+    private:
+        // the audio subsystem is initialized on its own so it can live next to a window
+        struct audio_subsystem {
+            audio_subsystem();
+            ~audio_subsystem();
+        };
+
+        audio_subsystem _subsystem;
+        io::audio::audio_buffer _buffer;
+        SDL2pp::AudioDevice _device;
+        io::audio::resampler _resampler;
+        std::vector<io::audio::sample> _resampled;
+    public:
+        audio_output();
+        ~audio_output();
+
+        audio_output(const audio_output&) = delete;
+        audio_output& operator=(const audio_output&) = delete;
+
+        // Moves the samples synthesized so far into the device buffer
+        void push(io::audio::apu& apu);
+
+        // Sleeps while the buffer holds more than half its capacity and a frame
+        void wait() const;
+
+        io::audio::audio_telemetry telemetry() const;
+    };
+}
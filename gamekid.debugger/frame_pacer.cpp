@@ -0,0 +1,32 @@
+#include "frame_pacer.h"
+#include <gamekid/io/video/lcd_timing.h>
+#include <thread>
+
+using namespace gamekid::debugger;
+
+frame_pacer::frame_pacer(clock::duration period) : _period(period), _next(clock::now() + period) {
+}
+
+frame_pacer::clock::duration frame_pacer::gameboy_frame() {
+    using namespace gamekid::io::video;
+
+    return std::chrono::duration_cast<clock::duration>(std::chrono::nanoseconds(
+        1000000000ull * lcd_timing::cycles_per_frame / lcd_timing::cycles_per_second));
+}
+
+void frame_pacer::wait() {
+    const clock::time_point now = clock::now();
+
+    if (now < _next) {
+        std::this_thread::sleep_until(_next);
+        _next += _period;
+    } else if (now - _next > _period * 4) {
+        reset();
+    } else {
+        _next += _period;
+    }
+}
+
+void frame_pacer::reset() {
+    _next = clock::now() + _period;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <chrono>
+
+namespace gamekid::debugger {
+
+    // Keeps emulated frames at the gameboy's rate (~59.7 fps) on the steady clock.
+    // Sleeps only when ahead of schedule, and drops the schedule instead of
+    // running frames back to back when it falls far behind (a breakpoint, a dragged window).
+    class frame_pacer {
+    public:
+        using clock = std::chrono::steady_clock;
+    private:
+        clock::duration _period;
+        clock::time_point _next;
+    public:
+        explicit frame_pacer(clock::duration period);
+
+        // 70224 cycles at 4194304hz
+        static clock::duration gameboy_frame();
+
+        // Waits for the start of the next frame
+        void wait();
+
+        // Starts a new schedule from now (after a pause)
+        void reset();
+    };
+}
@@ -5,6 +5,7 @@
 #include "gamekid/utils/str.h"
 #include "gamekid/cpu/operands_container.h"
 #include "window.h"
+#include "audio_output.h"
 #include <thread>
 #include "gamekid/io/video/tile.h"
 #include <atomic>
@@ -27,6 +28,7 @@ void view(gamekid::runner& runner, const std::vector<std::string>& args);
 void del(gamekid::runner& runner, const std::vector<std::string>& args);
 void breakpoints(gamekid::runner& runner, const std::vector<std::string>& args);
 void dump_screen(gamekid::runner& runner, const std::vector<std::string>& args);
+void memory_usage(gamekid::runner& runner, const std::vector<std::string>& args);
 
 const std::map<std::string, command> commands =
 {
@@ -40,7 +42,8 @@ const std::map<std::string, command> commands =
     { "view", view},
     { "del", del},
     { "breakpoints", breakpoints},
-    { "dump_screen", dump_screen}
+    { "dump_screen", dump_screen},
+    { "memory", memory_usage }
 };
 
 bool debugger_running;
@@ -102,8 +105,28 @@ std::vector<std::string> get_user_command() {
 }
 
 void run(gamekid::runner& runner, const std::vector<std::string>& args) {
-    runner.run_until_break();
- }
+    // runs in real time (by the audio clock) with sound until a breakpoint,
+    // or as fast as it can when there is no audio device
+    std::unique_ptr<gamekid::debugger::audio_output> audio;
+
+    try {
+        audio = std::make_unique<gamekid::debugger::audio_output>();
+    } catch (const std::exception& e) {
+        std::cerr << "No audio: " << e.what() << std::endl;
+
+        // the samples are dropped every frame, nothing plays them
+        while (runner.run_frame()) {
+            runner.apu().clear_samples();
+        }
+
+        return;
+    }
+
+    while (runner.run_frame()) {
+        audio->push(runner.apu());
+        audio->wait();
+    }
+}
 
 void add_breakpoint(gamekid::runner& runner, const std::vector<std::string>& args) {
     if (args.size() <= 1) {
@@ -250,6 +273,19 @@ void breakpoints(gamekid::runner& runner, const std::vector<std::string>& args)
     }
 }
 
+void memory_usage(gamekid::runner& runner, const std::vector<std::string>& args) {
+    const gamekid::memory_report report = runner.memory_usage();
+
+    std::cout << std::dec;
+    std::cout << "runner object: " << report.object << std::endl;
+    std::cout << "ram: " << report.ram_owned << " (shared " << report.ram_shared << ")" << std::endl;
+    std::cout << "rom (shared): " << report.rom << std::endl;
+    std::cout << "instructions (shared): " << report.instructions << std::endl;
+    std::cout << "buffers: " << report.buffers << std::endl;
+    std::cout << "states: " << report.states << std::endl;
+    std::cout << "total: " << report.total() << std::endl;
+}
+
 const std::array<byte, 4> palette = {0b00, 0b11, 0b11, 0b11 };
 
 void write_tile(gamekid::debugger::window& wnd, const gamekid::video::io::tile& t, gamekid::debugger::point p) {
@@ -258,14 +294,13 @@ void write_tile(gamekid::debugger::window& wnd, const gamekid::video::io::tile&
         for (byte x = 0; x<8; ++x) {
             const byte color_index = t.get_color(x, y);
             const byte color_value = palette.at(color_index);
-            const SDL2pp::Color& color = gamekid::debugger::colors.at(color_value);
-            wnd.put_pixel(gamekid::debugger::point(p.x + x, p.y + y), color);
+            wnd.put_pixel(gamekid::debugger::point(p.x + x, p.y + y), color_value);
         }
     }
 }
 
 void dump_screen(gamekid::runner& runner, const std::vector<std::string>& args) {
-    gamekid::debugger::window wnd;
+    gamekid::debugger::window wnd(256, 256, 5);
     
     std::vector<byte> tile_data = runner.dump(0x8000, 0x1000);
     std::vector<byte> tile_map = runner.dump(0x9800, 1024);
@@ -282,8 +317,8 @@ void dump_screen(gamekid::runner& runner, const std::vector<std::string>& args)
     wnd.show();
     wnd.render();
 
-    while (wnd.poll_events()) {
-        SDL_Delay(500);
+    // nothing changes on screen, so only wake up for events
+    while (wnd.wait_events(1000)) {
     }
 
 }
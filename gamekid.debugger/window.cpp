@@ -4,40 +4,75 @@
 
 namespace gamekid::debugger {
 
-    const int screen_size = 256;
-    const int zoom = 5;
+    bool window::handle_event(const SDL_Event& e) {
+        if (e.type == SDL_QUIT)
+            return false;
+
+        if ((e.type == SDL_KEYDOWN || e.type == SDL_KEYUP) && !e.key.repeat && _on_key) {
+            _on_key(e.key.keysym.sym, e.type == SDL_KEYDOWN);
+        }
+
+        return true;
+    }
 
     bool window::poll_events() {
         SDL_Event e;
-        
-        while (!SDL_PollEvent(&e)) {   
-            if (e.type == SDL_QUIT)
-                return false;
+        bool running = true;
+
+        while (SDL_PollEvent(&e)) {
+            running = handle_event(e) && running;
         }
-        
-        return true;
+
+        return running;
+    }
+
+    bool window::wait_events(int timeout_ms) {
+        SDL_Event e;
+
+        if (SDL_WaitEventTimeout(&e, timeout_ms) && !handle_event(e)) {
+            return false;
+        }
+
+        return poll_events();
+    }
+
+    void window::on_key(key_handler handler) {
+        _on_key = std::move(handler);
     }
 
-    window::window() :
+    window::window(int width, int height, int zoom, bool vsync) :
         _sdl(SDL_INIT_VIDEO),
-        _window("gamekid", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 
-            screen_size*zoom, screen_size*zoom, 0),
-        _renderer(_window, -1, SDL_RENDERER_ACCELERATED) {
+        _window("gamekid", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+            width*zoom, height*zoom, 0),
+        // present waits for the vertical sync instead of tearing
+        _renderer(_window, -1, SDL_RENDERER_ACCELERATED | (vsync ? SDL_RENDERER_PRESENTVSYNC : 0)),
+        _texture(_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, width, height),
+        _width(width), _height(height), _pixels(width * height, 0), _converter(io::video::rgba8888_palette()) {
         _renderer.Clear();
     }
 
     void window::render() {
-        _renderer.Present();
+        render(_pixels.data());
     }
 
-    void window::put_pixel(point location, SDL2pp::Color value) {
-        _renderer.SetDrawColor(value);
+    void window::render(const byte* pixels) {
+        {
+            SDL2pp::Texture::LockHandle lock = _texture.Lock();
+            auto row = static_cast<unsigned char*>(lock.GetPixels());
 
-        for (int y = location.y*zoom; y<location.y*zoom+zoom; ++y) {
-            for (int x = location.x*zoom; x < location.x*zoom+zoom; ++x) {
-                _renderer.DrawPoint(x, y);
+            // the pitch may be larger than the width
+            for (int y = 0; y < _height; ++y, row += lock.GetPitch()) {
+                _converter.convert_row(pixels + y * _width, _width, reinterpret_cast<dword*>(row));
             }
         }
+
+        _renderer.Clear();
+        _renderer.Copy(_texture);
+        _renderer.Present();
+    }
+
+    void window::put_pixel(point location, byte color) {
+        _pixels[location.y * _width + location.x] = color;
     }
 
     void window::show() {
@@ -45,5 +80,3 @@ namespace gamekid::debugger {
     }
 
 }
-
-
@@ -1,6 +1,10 @@
 #pragma once
 #include <SDL2pp/SDL2pp.hh>
+#include <gamekid/utils/types.h>
+#include <gamekid/io/video/palette_converter.h>
 #include <array>
+#include <functional>
+#include <vector>
 
 namespace gamekid::debugger {
     struct point {
@@ -10,24 +14,42 @@ namespace gamekid::debugger {
         }
     };
 
-    const std::array<SDL2pp::Color, 4> colors = {
-        SDL2pp::Color { 0xFF, 0xFF, 0xFF },
-        SDL2pp::Color { 0x99, 0x99, 0x99 },
-        SDL2pp::Color { 0x55, 0x55, 0x55 },
-        SDL2pp::Color { 0x00, 0x00, 0x00 }
-    };
+    using key_handler = std::function<void(SDL_Keycode key, bool pressed)>;
 
+    // A window that shows an indexed (0-3) pixel buffer.
+    // The buffer is converted into a streaming RGBA8888 texture once per render,
+    // and the texture is scaled to the window by the gpu.
     class window {
     private:
         SDL2pp::SDL _sdl;
         SDL2pp::Window _window;
         SDL2pp::Renderer _renderer;
+        SDL2pp::Texture _texture;
+        int _width;
+        int _height;
+        std::vector<byte> _pixels;
+        io::video::palette_converter<dword> _converter;
+        key_handler _on_key;
+
+        bool handle_event(const SDL_Event& e);
     public:
-        window();
+        // Without vsync the caller paces the frames (by the audio clock)
+        window(int width, int height, int zoom, bool vsync = true);
+
+        // Drains the pending events without blocking, returns false when the window was closed
         bool poll_events();
-        void put_pixel(point location, SDL2pp::Color value);
+
+        // Sleeps until an event arrives (or the timeout passes) and drains the queue
+        bool wait_events(int timeout_ms);
+
+        void on_key(key_handler handler);
+        void put_pixel(point location, byte color);
+
+        // Uploads the window's own pixel buffer and presents it
         void render();
+
+        // Uploads width * height indexed pixels and presents them
+        void render(const byte* pixels);
         void show();
     };
 }
-
@@ -1,4 +1,3 @@
-#include <gamekid/system.h>
 #include <gamekid/cpu/opcode_decoder.h>
 #include <gamekid/utils/files.h>
 #include <gamekid/utils/bytes.h>
@@ -14,9 +13,7 @@ int main(int argc, const char** argv){
     std::vector<byte> opcodes = gamekid::utils::files::read_file(argv[1]);
     const byte* opcode_ptr = opcodes.data();
     
-    gamekid::system system;
-    gamekid::cpu::instruction_set s(system.cpu());
-    gamekid::cpu::opcode_decoder d(s);
+    const gamekid::cpu::opcode_decoder& d = gamekid::cpu::opcode_decoder::shared();
     
     for (size_t i=0; i<opcodes.size();) {
         const word opcode_word = gamekid::utils::bytes::read_value<word>(opcode_ptr + i);
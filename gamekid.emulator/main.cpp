@@ -1,3 +1,152 @@
-int main() {
+#include <gamekid/runner.h>
+#include <gamekid/utils/files.h>
+#include <gamekid/utils/convert.h>
+#include <gamekid/io/video/lcd_timing.h>
+#include <gamekid/link/socket_link.h>
+#include "gamekid.debugger/window.h"
+#include "gamekid.debugger/frame_pacer.h"
+#include "gamekid.debugger/audio_output.h"
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#undef main
+
+using namespace gamekid::io::video;
+
+int main(const int argc, const char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Missing filename argument";
+        return -1;
+    }
+
+    gamekid::rom::cartridge cart(gamekid::utils::files::read_file(argv[1]));
+    gamekid::runner runner(std::move(cart));
+
+    // gamekid <rom> listen <port> | connect <host> <port> plays linked with another emulator
+    std::unique_ptr<gamekid::link::socket_link> link;
+
+    if (argc >= 4 && std::string(argv[2]) == "listen") {
+        const word port = gamekid::utils::convert::to_number<word>(argv[3]);
+        std::cout << "Waiting for the other end on port " << port << std::endl;
+        link = std::make_unique<gamekid::link::socket_link>(gamekid::link::socket::listen(port).accept());
+    } else if (argc >= 5 && std::string(argv[2]) == "connect") {
+        const word port = gamekid::utils::convert::to_number<word>(argv[4]);
+        link = std::make_unique<gamekid::link::socket_link>(gamekid::link::socket::connect(argv[3], port));
+    }
+
+    // gamekid <rom> ahead <frames> hides the game's input lag by showing the frames ahead
+    dword ahead = 0;
+
+    if (argc >= 4 && std::string(argv[2]) == "ahead") {
+        ahead = gamekid::utils::convert::to_number<dword>(argv[3]);
+    }
+
+    // the emulation follows the audio clock, or the steady clock when there is no audio device
+    std::unique_ptr<gamekid::debugger::audio_output> audio;
+
+    try {
+        audio = std::make_unique<gamekid::debugger::audio_output>();
+    } catch (const std::exception& e) {
+        std::cerr << "No audio: " << e.what() << std::endl;
+    }
+
+    // with audio the display is not waited for, its refresh rate doesn't have to be 59.7hz
+    gamekid::debugger::window wnd(screen_width, screen_height, 4, audio == nullptr);
+    wnd.show();
+
+    // F5 saves the state next to the rom, F9 loads it
+    const std::string state_file = std::string(argv[1]) + ".state";
+    gamekid::state::snapshot state;
+
+    // holding R plays the last frames backwards
+    runner.rewind(16 << 20);
+    bool rewinding = false;
+
+    bool paused = false;
+    wnd.on_key([&paused, &rewinding, &runner, &state, &state_file](SDL_Keycode key, bool pressed) {
+        if (pressed && key == SDLK_p) {
+            paused = !paused;
+        }
+
+        if (key == SDLK_r) {
+            rewinding = pressed;
+        }
+
+        try {
+            if (pressed && key == SDLK_F5) {
+                runner.save(state);
+                state.save_file(state_file);
+            } else if (pressed && key == SDLK_F9) {
+                state.load_file(state_file);
+                runner.load(state);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "State: " << e.what() << std::endl;
+        }
+
+        using gamekid::io::joypad_button;
+        static const std::map<SDL_Keycode, joypad_button> buttons = {
+            { SDLK_z, joypad_button::a },
+            { SDLK_x, joypad_button::b },
+            { SDLK_BACKSPACE, joypad_button::select },
+            { SDLK_RETURN, joypad_button::start },
+            { SDLK_RIGHT, joypad_button::right },
+            { SDLK_LEFT, joypad_button::left },
+            { SDLK_UP, joypad_button::up },
+            { SDLK_DOWN, joypad_button::down },
+        };
+
+        // applied at the start of the frame that runs next
+        const auto button = buttons.find(key);
+
+        if (button != buttons.end()) {
+            runner.joypad().post({ std::uint64_t(runner.lcd().frame_count()), gamekid::io::input_time::frame, 
+                button->second, pressed });
+        }
+    });
+
+    gamekid::debugger::frame_pacer pacer(gamekid::debugger::frame_pacer::gameboy_frame());
+
+    while (true) {
+        if (paused) {
+            // sleep until something happens, nothing is drawn while paused
+            if (!wnd.wait_events(250)) break;
+            pacer.reset();
+            continue;
+        }
+
+        // input is drained once per frame
+        if (!wnd.poll_events()) break;
+
+        // a linked runner runs in the link's windows, which both ends count the same way
+        if (link) {
+            link->run(runner, lcd_timing::cycles_per_frame);
+        } else if (rewinding) {
+            // the screen isn't a part of the state, the frame before the previous one is run again to draw it
+            if (runner.step_back()) {
+                runner.step_back();
+                runner.run_frame();
+            }
+        } else if (ahead > 0) {
+            runner.run_frame_ahead(ahead);
+
+            if (runner.lcd().frame_count() % 600 == 0) {
+                std::cout << "Run ahead: " << runner.ahead_cost().frame_budget_percent << "% of the frame" << std::endl;
+            }
+        } else {
+            runner.run_frame();
+        }
+        wnd.render(runner.lcd().screen().data());
+
+        if (audio) {
+            audio->push(runner.apu());
+            audio->wait();
+        } else {
+            runner.apu().clear_samples();
+            pacer.wait();
+        }
+    }
+
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,242 @@
+#include "pch.h"
+#include "gamekid/io/audio/apu.h"
+#include "gamekid/io/audio/audio_timing.h"
+#include "gamekid/io/audio/audio_buffer.h"
+#include "gamekid/io/audio/resampler.h"
+#include "gamekid/io/io_registers.h"
+#include "gamekid/state/snapshot.h"
+
+namespace gamekid::tests {
+    using namespace io::audio;
+
+    // Channel 1 at 1024hz, 50% duty, full volume on both outputs
+    void play_square(apu& apu) {
+        apu.store(NR_52, 0x80);
+        apu.store(NR_50, 0x77);
+        apu.store(NR_51, 0x11);
+        apu.store(NR_11, 0x80);
+        apu.store(NR_12, 0xF0);
+        apu.store(NR_13, 0x80);
+        apu.store(NR_14, 0x87);
+    }
+
+    TEST(APU, SQUARE_FREQUENCY) {
+        for (auto mode : { synthesis::band_limited, synthesis::oversampled }) {
+            apu apu(mode);
+            play_square(apu);
+
+            // one second
+            for (dword i = 0; i < audio_timing::cycles_per_second / 4; ++i) {
+                apu.tick(4);
+            }
+            apu.flush();
+
+            const std::vector<sample>& samples = apu.samples();
+            ASSERT_EQ(audio_timing::sample_rate * 2, samples.size());
+
+            // skips the ringing of the first step (from silence)
+            size_t rising_edges = 0;
+            for (size_t i = blep_buffer::kernel_width * 2; i < samples.size(); i += 2) {
+                if (samples[i - 2] < 0 && samples[i] >= 0) ++rising_edges;
+                ASSERT_EQ(samples[i], samples[i + 1]);
+            }
+
+            ASSERT_EQ(1024, rising_edges);
+        }
+    }
+
+    TEST(APU, BLEP_STEP) {
+        blep_buffer buffer;
+        buffer.add_delta(10, 1 << (blep_buffer::phase_bits - 1), 1000);
+
+        std::array<sample, 40> out{};
+        buffer.read(20, out.data(), 1);
+        buffer.read(20, out.data() + 20, 1);
+
+        // the step is smoothed over the kernel and then settles on the exact level
+        ASSERT_EQ(0, out[9]);
+        ASSERT_GT(out[17], 0);
+        ASSERT_LT(out[17], 1000);
+        for (size_t i = 10 + blep_buffer::kernel_width; i < out.size(); ++i) {
+            ASSERT_EQ(1000, out[i]);
+        }
+    }
+
+    TEST(APU, LENGTH_COUNTER_STOPS_CHANNEL) {
+        apu apu;
+        play_square(apu);
+        ASSERT_EQ(0xF1, apu.load(NR_52));
+
+        // 2 / 256 of a second
+        apu.store(NR_11, 0x80 | 62);
+        apu.store(NR_14, 0xC7);
+
+        apu.tick(audio_timing::frame_sequencer_cycles * 3);
+        ASSERT_EQ(0xF1, apu.load(NR_52));
+
+        apu.tick(audio_timing::frame_sequencer_cycles * 2);
+        ASSERT_EQ(0xF0, apu.load(NR_52));
+    }
+
+    TEST(APU, POWER_OFF_CLEARS_REGISTERS) {
+        apu apu;
+        play_square(apu);
+        apu.store(0xFF30, 0x12);
+
+        apu.store(NR_52, 0x00);
+        ASSERT_EQ(0x70, apu.load(NR_52));
+        ASSERT_EQ(0x3F, apu.load(NR_11));
+        ASSERT_EQ(0x00, apu.load(NR_50));
+        ASSERT_EQ(0x12, apu.load(0xFF30));
+
+        // ignored while the apu is off
+        apu.store(NR_50, 0x77);
+        ASSERT_EQ(0x00, apu.load(NR_50));
+    }
+
+    // Notes with a sweep, a wave and noise, changed every few hundred cycles
+    void play_song(apu& apu, bool flush_every_write) {
+        for (word i = 0; i < 16; ++i) {
+            apu.store(0xFF30 + i, static_cast<byte>(i * 0x11 + 3));
+        }
+
+        play_square(apu);
+        apu.store(NR_51, 0xFF);
+        apu.store(NR_10, 0x23);
+        apu.store(NR_22, 0xA3);
+        apu.store(NR_30, 0x80);
+        apu.store(NR_32, 0x20);
+        apu.store(NR_42, 0xF1);
+        apu.store(NR_43, 0x35);
+
+        for (dword i = 0; i < 400; ++i) {
+            apu.store(NR_23, static_cast<byte>(i * 37));
+            apu.store(NR_24, 0x85);
+            if (i % 5 == 0) apu.store(NR_34, 0x86);
+            if (i % 7 == 0) apu.store(NR_44, 0x80);
+            if (i % 11 == 0) apu.store(NR_14, 0x86);
+
+            apu.tick(300 + i);
+            if (flush_every_write) apu.flush();
+        }
+
+        apu.flush();
+    }
+
+    TEST(APU, BATCHED_SYNTHESIS_MATCHES_FLUSHING) {
+        for (auto mode : { synthesis::band_limited, synthesis::oversampled }) {
+            apu batched(mode);
+            apu flushed(mode);
+
+            play_song(batched, false);
+            play_song(flushed, true);
+
+            ASSERT_GT(batched.samples().size(), 0u);
+            ASSERT_TRUE(batched.samples() == flushed.samples());
+        }
+    }
+
+    TEST(APU, STATE_OF_THE_OTHER_SYNTHESIS_KEEPS_THE_MODE) {
+        for (auto mode : { synthesis::band_limited, synthesis::oversampled }) {
+            const synthesis other = mode == synthesis::band_limited ? synthesis::oversampled : synthesis::band_limited;
+
+            // a state of the other synthesis, after a little more than a frame
+            apu saved(other);
+            play_square(saved);
+            saved.tick(70001);
+            saved.flush();
+
+            state::snapshot image;
+            image.clear();
+            saved.save(image);
+
+            apu expected(mode);
+            play_square(expected);
+            expected.tick(70001);
+            expected.flush();
+            expected.clear_samples();
+
+            apu loaded(mode);
+            image.rewind();
+            loaded.load(image);
+            ASSERT_TRUE(mode == loaded.mode());
+
+            for (apu* current : { &expected, &loaded }) {
+                current->tick(70000);
+                current->flush();
+            }
+
+            // the channels go on, only the first samples ring from silence
+            const std::vector<sample>& expected_samples = expected.samples();
+            const std::vector<sample>& loaded_samples = loaded.samples();
+            ASSERT_EQ(expected_samples.size(), loaded_samples.size());
+
+            for (size_t i = blep_buffer::kernel_width * 2 * 2; i < expected_samples.size(); ++i) {
+                ASSERT_EQ(expected_samples[i], loaded_samples[i]);
+            }
+        }
+    }
+
+    TEST(APU, AUDIO_BUFFER_UNDERRUN_FADES) {
+        audio_buffer buffer(4);
+        const sample frames[] = { 100, -100, 1000, -1000 };
+        buffer.push(frames, 4);
+
+        std::array<sample, 64> out{};
+        buffer.pop(out.data(), out.size());
+
+        ASSERT_EQ(100, out[0]);
+        ASSERT_EQ(-1000, out[3]);
+
+        // the missing frames fade from the last frame to silence
+        ASSERT_LT(out[4], 1000);
+        ASSERT_GT(out[4], out[6]);
+        ASSERT_EQ(-out[4], out[5]);
+        ASSERT_EQ(30u, buffer.telemetry().underruns);
+    }
+
+    TEST(APU, AUDIO_BUFFER_OVERRUN_DROPS) {
+        audio_buffer buffer(4);
+        const std::array<sample, 12> frames{};
+        buffer.push(frames.data(), frames.size());
+
+        const audio_telemetry telemetry = buffer.telemetry();
+        ASSERT_EQ(4u, telemetry.fill);
+        ASSERT_EQ(4u, telemetry.capacity);
+        ASSERT_EQ(2u, telemetry.overruns);
+    }
+
+    TEST(APU, RESAMPLER_UNITY_RATIO) {
+        std::vector<sample> input;
+        for (int i = 0; i < 200; ++i) {
+            input.push_back(static_cast<sample>(i * 100));
+            input.push_back(static_cast<sample>(-i * 100));
+        }
+
+        // in two calls, the second continues where the first stopped
+        resampler resampler;
+        std::vector<sample> output;
+        resampler.process(input.data(), 100, 1.0, output);
+        resampler.process(input.data() + 200, 100, 1.0, output);
+
+        // the input is delayed by the two frames of history
+        ASSERT_EQ(input.size(), output.size());
+        ASSERT_EQ(0, output[0]);
+        for (size_t i = 4; i < output.size(); ++i) {
+            ASSERT_EQ(input[i - 4], output[i]);
+        }
+    }
+
+    TEST(APU, RESAMPLER_DYNAMIC_RATIO) {
+        ASSERT_DOUBLE_EQ(1.005, dynamic_ratio(0, 1000));
+        ASSERT_DOUBLE_EQ(1.0, dynamic_ratio(500, 1000));
+        ASSERT_DOUBLE_EQ(0.995, dynamic_ratio(1000, 1000));
+
+        const std::vector<sample> input(48000 * 2, 0);
+        resampler resampler;
+        std::vector<sample> output;
+        resampler.process(input.data(), 48000, dynamic_ratio(0, 1000), output);
+
+        ASSERT_NEAR(48000 * 1.005, output.size() / 2.0, 3);
+    }
+}
@@ -0,0 +1,140 @@
+#include "pch.h"
+#include "gamekid/batch/batch_runner.h"
+#include "gamekid/batch/input_movie.h"
+#include "gamekid/batch/work_stealing_pool.h"
+#include "gamekid/rom/cartridge.h"
+#include "gamekid/rom/header_offsets.h"
+#include "gamekid/utils/files.h"
+#include <atomic>
+#include <filesystem>
+
+namespace gamekid::tests {
+
+    // a rom only cartridge which passes the boot rom's checks, and keeps the action buttons at 0xC000
+    static std::vector<byte> joypad_rom() {
+        std::vector<byte> rom(0x8000, 0);
+        std::copy(rom::nintendo_logo.begin(), rom::nintendo_logo.end(), rom.begin() + rom::header_offsets::logo.start);
+
+        const byte entry[] = { 0x00, 0xC3, 0x50, 0x01 };
+        std::copy(std::begin(entry), std::end(entry), rom.begin() + 0x100);
+
+        // ld a, 0x10; ldh [0x00], a; loop: ldh a, [0x00]; ld [0xC000], a; jr loop
+        const byte program[] = { 0x3E, 0x10, 0xE0, 0x00, 0xF0, 0x00, 0xEA, 0x00, 0xC0, 0x18, 0xF9 };
+        std::copy(std::begin(program), std::end(program), rom.begin() + 0x150);
+
+        rom[rom::header_offsets::header_checksum.start] = rom::cartridge(std::vector<byte>(rom)).calculate_header_checksum();
+        return rom;
+    }
+
+    TEST(BATCH, POOL_RUNS_EVERY_TASK_ONCE) {
+        batch::work_stealing_pool pool(4);
+        ASSERT_EQ(4, pool.size());
+
+        std::vector<std::atomic<int>> runs(1000);
+        std::atomic<bool> bad_worker = false;
+
+        for (size_t index = 0; index < runs.size(); ++index) {
+            // all on one queue, the other workers steal them
+            pool.submit(0, [&runs, &bad_worker, &pool, index](size_t worker) {
+                bad_worker = bad_worker || worker >= pool.size();
+                ++runs[index];
+            });
+        }
+
+        pool.wait();
+
+        for (const std::atomic<int>& count : runs) {
+            ASSERT_EQ(1, count.load());
+        }
+
+        ASSERT_FALSE(bad_worker);
+    }
+
+    TEST(BATCH, INPUT_MOVIE_IS_PARSED_IN_THE_ORDER_OF_ITS_FRAMES) {
+        const batch::input_movie movie = batch::input_movie::parse(
+            "# a jump\n"
+            "10 a down\n"
+            "\n"
+            "3 right down\n"
+            "10 right up\n"
+            "12 a up\n");
+
+        const std::vector<io::joypad_event>& events = movie.events();
+        ASSERT_EQ(4, events.size());
+        ASSERT_EQ(3, events[0].time);
+        ASSERT_TRUE(io::joypad_button::right == events[0].button);
+        ASSERT_TRUE(io::joypad_button::a == events[1].button);
+        ASSERT_TRUE(events[1].pressed);
+        ASSERT_TRUE(io::joypad_button::right == events[2].button);
+        ASSERT_FALSE(events[2].pressed);
+        ASSERT_EQ(12, events[3].time);
+
+        io::joypad_input joypad;
+        ASSERT_EQ(1, movie.post(joypad, 0, 9));
+        ASSERT_EQ(3, movie.post(joypad, 1, 10));
+        ASSERT_EQ(4, movie.post(joypad, 3, 100));
+
+        ASSERT_THROW(batch::input_movie::parse("10 x down"), std::exception);
+        ASSERT_THROW(batch::input_movie::parse("10 a pressed"), std::exception);
+        ASSERT_THROW(batch::input_movie::parse("a down"), std::exception);
+    }
+
+    TEST(BATCH, PARSE_JOBS) {
+        const std::vector<batch::batch_job> jobs = batch::batch_runner::parse_jobs(
+            "# frames rom movie\n"
+            "600 tetris.gb\n"
+            "  \n"
+            "60 tetris.gb start.inp\n");
+
+        ASSERT_EQ(2, jobs.size());
+        ASSERT_EQ(600, jobs[0].frames);
+        ASSERT_EQ("tetris.gb", jobs[0].rom);
+        ASSERT_TRUE(jobs[0].movie.empty());
+        ASSERT_EQ(60, jobs[1].frames);
+        ASSERT_EQ("start.inp", jobs[1].movie);
+
+        ASSERT_THROW(batch::batch_runner::parse_jobs("tetris.gb 600"), std::exception);
+    }
+
+    TEST(BATCH, RESULTS_DONT_DEPEND_ON_THE_THREADS) {
+        const std::filesystem::path directory = std::filesystem::temp_directory_path() / "gamekid_batch_tests";
+        std::filesystem::create_directories(directory);
+        const std::string rom = (directory / "joypad.gb").string();
+        const std::string movie = (directory / "a.inp").string();
+
+        const std::vector<byte> rom_data = joypad_rom();
+        utils::files::write_file(rom, rom_data.data(), rom_data.size());
+        const std::string movie_text = "5 a down\n";
+        utils::files::write_file(movie, reinterpret_cast<const byte*>(movie_text.data()), movie_text.size());
+
+        std::vector<batch::batch_job> jobs = batch::batch_runner::instances({ rom, "", 10 }, 6);
+        jobs.push_back({ rom, movie, 10 });
+        jobs.push_back({ (directory / "missing.gb").string(), "", 10 });
+
+        std::vector<std::vector<batch::batch_result>> runs;
+
+        for (size_t threads : { 1, 4 }) {
+            batch::batch_runner batch({ threads });
+            std::vector<batch::batch_result> results(jobs.size());
+            batch.run(jobs, [&results](const batch::batch_result& result) { results[result.job] = result; });
+            runs.push_back(results);
+        }
+
+        for (const std::vector<batch::batch_result>& results : runs) {
+            for (size_t index = 0; index < 7; ++index) {
+                ASSERT_TRUE(results[index].error.empty());
+                ASSERT_EQ(10, results[index].frames);
+                ASSERT_EQ(runs[0][index].screen, results[index].screen);
+                ASSERT_EQ(runs[0][index].state, results[index].state);
+            }
+
+            // the movie pressed a, which the rom keeps in its ram
+            ASSERT_NE(results[0].state, results[6].state);
+
+            ASSERT_FALSE(results[7].error.empty());
+            ASSERT_EQ(0, results[7].frames);
+        }
+
+        std::filesystem::remove_all(directory);
+    }
+}
@@ -0,0 +1,162 @@
+#include "pch.h"
+#include "gamekid/io/joypad_input.h"
+#include "gamekid/io/scheduler.h"
+#include "gamekid/io/io_registers.h"
+#include "gamekid/io/interrupts.h"
+#include "gamekid/memory/gameboy_memory_map.h"
+#include "gamekid/memory/memory.h"
+#include "test_rom_map.h"
+
+namespace gamekid::tests {
+    using io::joypad_button;
+    using io::joypad_event;
+    using io::input_time;
+
+    TEST(JOYPAD, P1_SELECTS_A_ROW) {
+        io::joypad_cell cell;
+        cell.set_status(joypad_button::a, true);
+        cell.set_status(joypad_button::down, true);
+
+        // nothing is selected
+        ASSERT_EQ(0xFF, cell.load());
+
+        // buttons
+        cell.store(0x10);
+        ASSERT_EQ(0xDE, cell.load());
+
+        // directions
+        cell.store(0x20);
+        ASSERT_EQ(0xE7, cell.load());
+
+        // both rows
+        cell.store(0x00);
+        ASSERT_EQ(0xC6, cell.load());
+    }
+
+    TEST(JOYPAD, INTERRUPT_ON_A_SELECTED_LINE) {
+        io::joypad_cell cell;
+        cell.store(0x10);
+
+        // directions are not selected
+        ASSERT_FALSE(cell.set_status(joypad_button::up, true));
+        ASSERT_TRUE(cell.set_status(joypad_button::start, true));
+
+        // the line is already low
+        ASSERT_FALSE(cell.set_status(joypad_button::start, true));
+        ASSERT_FALSE(cell.set_status(joypad_button::start, false));
+    }
+
+    TEST(JOYPAD, EVENTS_ARE_APPLIED_AT_THEIR_CYCLE) {
+        io::joypad_input input;
+        input.cell().store(0x10);
+        ASSERT_EQ(io::joypad_input::never, input.next_event());
+
+        ASSERT_TRUE(input.post({ 100, input_time::cycle, joypad_button::b, true }));
+        ASSERT_TRUE(input.post({ 40, input_time::cycle, joypad_button::a, true }));
+
+        // nothing is taken before the drain
+        ASSERT_EQ(io::joypad_input::never, input.next_event());
+        input.drain(0);
+        ASSERT_EQ(40, input.next_event());
+
+        ASSERT_FALSE(input.tick(36));
+        ASSERT_EQ(0xDF, input.cell().load());
+
+        ASSERT_TRUE(input.tick(4));
+        ASSERT_EQ(0xDE, input.cell().load());
+        ASSERT_EQ(100, input.next_event());
+
+        ASSERT_TRUE(input.tick(64));
+        ASSERT_EQ(0xDC, input.cell().load());
+        ASSERT_EQ(io::joypad_input::never, input.next_event());
+
+        // late events are applied in the current cycle
+        input.post({ 0, input_time::cycle, joypad_button::a, false });
+        input.drain(0);
+        ASSERT_EQ(104, input.next_event());
+        input.tick(4);
+        ASSERT_EQ(0xDD, input.cell().load());
+    }
+
+    TEST(JOYPAD, FRAME_EVENTS_WAIT_FOR_THEIR_FRAME) {
+        io::joypad_input input;
+        input.cell().store(0x20);
+        input.post({ 2, input_time::frame, joypad_button::left, true });
+
+        input.drain(1);
+        input.tick(1000);
+        ASSERT_FALSE(input.cell().get_status(joypad_button::left));
+
+        input.drain(2);
+        ASSERT_EQ(1000, input.next_event());
+        ASSERT_TRUE(input.tick(4));
+        ASSERT_EQ(0xED, input.cell().load());
+    }
+
+    TEST(JOYPAD, RECORDING_REPLAYS_THE_SAME_INPUT) {
+        const auto run = [](io::joypad_input& input, const std::vector<joypad_event>& events) {
+            std::vector<byte> lines;
+            input.cell().store(0x10);
+
+            for (dword frame = 0; frame < 3; ++frame) {
+                for (const joypad_event& event : events) {
+                    if (event.unit == input_time::frame ? event.time == frame : frame == 0) {
+                        input.post(event);
+                    }
+                }
+
+                input.drain(frame);
+
+                for (int i = 0; i < 100; ++i) {
+                    input.tick(4);
+                    lines.push_back(input.cell().load());
+                }
+            }
+
+            return lines;
+        };
+
+        io::joypad_input live;
+        live.record(true);
+        const std::vector<byte> played = run(live, {
+            { 0, input_time::frame, joypad_button::a, true },
+            { 1, input_time::frame, joypad_button::a, false },
+            { 130, input_time::cycle, joypad_button::start, true },
+            { 2, input_time::frame, joypad_button::start, false },
+        });
+
+        ASSERT_EQ(4, live.recorded().size());
+
+        io::joypad_input replay;
+        ASSERT_EQ(played, run(replay, live.recorded()));
+    }
+
+    TEST(JOYPAD, SCHEDULER_REQUESTS_THE_INTERRUPT) {
+        test_rom_map rom;
+        io::video::lcd lcd;
+        io::audio::apu apu;
+        io::timer timer;
+        io::serial serial;
+        io::joypad_input joypad;
+        byte interrupts = 0;
+        io::scheduler scheduler{ lcd, apu, timer, serial, joypad, [&interrupts](byte interrupt) { interrupts |= interrupt; } };
+        memory::gameboy_memory_map memory_map{ rom, scheduler };
+        memory::memory memory{ memory_map };
+
+        memory.store_byte(P1, 0x20);
+        joypad.post({ 400, input_time::cycle, joypad_button::right, true });
+        joypad.drain(0);
+        scheduler.joypad_sync().reschedule();
+
+        for (dword i = 0; i < 396; i += 4) {
+            scheduler.advance(4);
+        }
+
+        ASSERT_EQ(0, interrupts);
+        ASSERT_EQ(0xEF, memory.load_byte(P1));
+
+        scheduler.advance(4);
+        ASSERT_EQ(io::interrupts::joypad, interrupts);
+        ASSERT_EQ(0xEE, memory.load_byte(P1));
+    }
+}
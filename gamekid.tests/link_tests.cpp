@@ -0,0 +1,138 @@
+#include "pch.h"
+#include "gamekid/io/serial.h"
+#include "gamekid/io/io_registers.h"
+#include "gamekid/link/link_cable.h"
+#include "gamekid/link/socket_link.h"
+#include <thread>
+
+namespace gamekid::tests {
+    using io::serial;
+    using link::link_cable;
+    using link::socket_link;
+
+    TEST(LINK, TRANSFER_WITHOUT_LINK) {
+        serial serial;
+        serial.store(SB, 0x42);
+        serial.store(SC, 0x81);
+        ASSERT_EQ(0xFF, serial.load(SC));
+
+        ASSERT_FALSE(serial.tick(serial::transfer_cycles - 1));
+        ASSERT_TRUE(serial.tick(1));
+        ASSERT_EQ(0xFF, serial.load(SB));
+        ASSERT_EQ(0x7F, serial.load(SC));
+    }
+
+    TEST(LINK, EXCHANGE_SHIFTS_BOTH_BYTES) {
+        serial master, slave;
+        master.linked(true);
+        slave.linked(true);
+
+        master.tick(100);
+        master.store(SB, 0x12);
+        master.store(SC, 0x81);
+        slave.store(SB, 0x34);
+        slave.store(SC, 0x80);
+
+        // nothing happens until the link shifts the bits
+        ASSERT_FALSE(master.tick(serial::transfer_cycles * 2));
+        ASSERT_EQ(serial::never, master.completion());
+
+        // the window ended, the slave's clock is behind the master's
+        slave.tick(serial::transfer_cycles * 2);
+        link_cable::exchange(master, slave);
+        ASSERT_EQ(100 + serial::transfer_cycles * 2, master.completion());
+        ASSERT_EQ(serial::transfer_cycles * 2, slave.completion());
+
+        ASSERT_TRUE(master.tick(4));
+        ASSERT_TRUE(slave.tick(4));
+        ASSERT_EQ(0x34, master.load(SB));
+        ASSERT_EQ(0x12, slave.load(SB));
+        ASSERT_FALSE(master.active());
+        ASSERT_FALSE(slave.active());
+    }
+
+    TEST(LINK, EXCHANGE_WAITS_FOR_THE_SERIAL_CLOCK) {
+        serial master, slave;
+        master.linked(true);
+        slave.linked(true);
+
+        master.store(SC, 0x81);
+        slave.store(SC, 0x80);
+        master.tick(1000);
+        slave.tick(1200);
+
+        // both complete when the master's serial clock shifted the last bit
+        link_cable::exchange(master, slave);
+        ASSERT_EQ(serial::transfer_cycles, master.completion());
+        ASSERT_EQ(1200 + serial::transfer_cycles - 1000, slave.completion());
+    }
+
+    TEST(LINK, EXCHANGE_WITHOUT_A_WAITING_END) {
+        serial master, other;
+        master.linked(true);
+        other.linked(true);
+
+        master.store(SB, 0x12);
+        master.store(SC, 0x81);
+        other.store(SB, 0x34);
+        master.tick(serial::transfer_cycles);
+        other.tick(serial::transfer_cycles);
+
+        link_cable::exchange(master, other);
+        ASSERT_TRUE(master.tick(4));
+        ASSERT_EQ(0xFF, master.load(SB));
+        ASSERT_EQ(0x34, other.load(SB));
+    }
+
+    TEST(LINK, SOCKET_LINK_LOOPBACK) {
+        link::socket listener = link::socket::listen(0);
+        serial master, slave;
+        master.linked(true);
+        slave.linked(true);
+
+        master.store(SB, 0x12);
+        master.store(SC, 0x81);
+        slave.store(SB, 0x34);
+        slave.store(SC, 0x80);
+        master.tick(1000);
+        slave.tick(2000);
+
+        // both ends wait for each other, the slave runs on its own thread
+        std::thread slave_end([&listener, &slave]() {
+            socket_link link(listener.accept());
+            link.exchange(slave);
+            link.exchange(slave);
+        });
+
+        socket_link link(link::socket::connect("127.0.0.1", listener.port()));
+        link.exchange(master);
+        ASSERT_EQ(serial::transfer_cycles, master.completion());
+
+        // the transfer is still active, the next window is a single transfer
+        ASSERT_EQ(serial::transfer_cycles, link.window());
+        master.tick(serial::transfer_cycles);
+        link.exchange(master);
+        slave_end.join();
+
+        ASSERT_EQ(0x34, master.load(SB));
+        ASSERT_EQ(2000 + serial::transfer_cycles - 1000, slave.completion());
+        ASSERT_EQ(2, link.windows());
+    }
+
+    TEST(LINK, SOCKET_SEND_TO_A_CLOSED_PEER_THROWS) {
+        link::socket listener = link::socket::listen(0);
+        link::socket sender = link::socket::connect("127.0.0.1", listener.port());
+        {
+            link::socket peer = listener.accept();
+        }
+
+        // the first sends may still be buffered, the lost connection is seen in a later one
+        // (without a signal that ends the process)
+        const std::vector<byte> data(0x10000, 0xAB);
+        ASSERT_THROW(
+            for (int i = 0; i < 1000; ++i) {
+                sender.send(data.data(), data.size());
+            },
+            std::exception);
+    }
+}
@@ -2,6 +2,7 @@
 #include <gamekid/memory/memory.h>
 #include <gamekid/memory/memory_map_offsets.h>
 #include "gamekid/memory/gameboy_memory_map.h"
+#include "gamekid/io/scheduler.h"
 #include "gamekid/rom/rom_only_map.h"
 #include "test_rom_map.h"
 
@@ -9,7 +10,12 @@ namespace gamekid::tests {
     TEST(MEMORY, ECHO_INTERNAL_MEMO) {
         test_rom_map tst;
         io::video::lcd tst_lcd;
-        gamekid::memory::gameboy_memory_map memory_map(tst, tst_lcd);
+        io::audio::apu tst_apu;
+        io::timer tst_timer;
+        io::serial tst_serial;
+        io::joypad_input tst_joypad;
+        io::scheduler tst_scheduler(tst_lcd, tst_apu, tst_timer, tst_serial, tst_joypad);
+        gamekid::memory::gameboy_memory_map memory_map(tst, tst_scheduler);
         gamekid::memory::memory m(memory_map);
 
         for (int offset = 0; offset<0x1e00; ++offset) {
@@ -23,4 +29,74 @@ namespace gamekid::tests {
             ASSERT_EQ(200, m.load_byte(a_address));
         }
     }
-}
\ No newline at end of file
+
+    TEST(MEMORY, WRITTEN_PAGES_ARE_DIRTY) {
+        test_rom_map tst;
+        io::video::lcd tst_lcd;
+        io::audio::apu tst_apu;
+        io::timer tst_timer;
+        io::serial tst_serial;
+        io::joypad_input tst_joypad;
+        io::scheduler tst_scheduler(tst_lcd, tst_apu, tst_timer, tst_serial, tst_joypad);
+        gamekid::memory::gameboy_memory_map memory_map(tst, tst_scheduler);
+        gamekid::memory::memory m(memory_map);
+
+        const dword start = memory_map.dirty.epoch();
+        ASSERT_TRUE(memory_map.dirty.since(start).none());
+
+        m.store_byte(0xC012, 1);
+        // the echo ram marks the internal ram it mirrors
+        m.store_byte(0xE105, 2);
+        m.store_word(0xD0FF, 0x1234);
+
+        std::vector<byte> written;
+        memory_map.dirty.for_each(start, [&written](byte index) { written.push_back(index); });
+        ASSERT_EQ((std::vector<byte>{ 0xC0, 0xC1, 0xD0, 0xD1 }), written);
+
+        // a consumer sees only the pages written since it last collected
+        dword epoch = start;
+        ASSERT_EQ(4, memory_map.dirty.collect(epoch).count());
+        ASSERT_TRUE(memory_map.dirty.since(epoch).none());
+
+        m.store_byte(0xD800, 3);
+        const std::bitset<256> dirty = memory_map.dirty.collect(epoch);
+        ASSERT_EQ(1, dirty.count());
+        ASSERT_TRUE(dirty[0xD8]);
+
+        // the older epoch still sees everything
+        ASSERT_EQ(5, memory_map.dirty.since(start).count());
+    }
+
+    TEST(MEMORY, SHARED_PAGES_ARE_COPIED_ON_WRITE) {
+        test_rom_map tst;
+        io::video::lcd tst_lcd;
+        io::audio::apu tst_apu;
+        io::timer tst_timer;
+        io::serial tst_serial;
+        io::joypad_input tst_joypad;
+        io::scheduler tst_scheduler(tst_lcd, tst_apu, tst_timer, tst_serial, tst_joypad);
+        gamekid::memory::gameboy_memory_map parent_map(tst, tst_scheduler);
+        gamekid::memory::gameboy_memory_map child_map(tst, tst_scheduler);
+        gamekid::memory::memory parent(parent_map);
+        gamekid::memory::memory child(child_map);
+
+        parent.store_byte(0xC000, 1);
+        parent.store_byte(0xD000, 2);
+        child_map.share(parent_map);
+        ASSERT_EQ(1, child.load_byte(0xC000));
+        ASSERT_EQ(2, child.load_byte(0xD000));
+
+        // each of them sees only its own writes
+        child.store_byte(0xC000, 3);
+        parent.store_byte(0xD000, 4);
+        ASSERT_EQ(1, parent.load_byte(0xC000));
+        ASSERT_EQ(3, child.load_byte(0xC000));
+        ASSERT_EQ(4, parent.load_byte(0xD000));
+        ASSERT_EQ(2, child.load_byte(0xD000));
+
+        // the echo ram writes the same copy
+        child.store_byte(0xF000, 5);
+        ASSERT_EQ(5, child.load_byte(0xD000));
+        ASSERT_EQ(4, parent.load_byte(0xD000));
+    }
+}
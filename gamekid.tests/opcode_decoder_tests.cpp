@@ -1,6 +1,7 @@
 #include "pch.h"
 #include <gamekid/cpu/cpu.h>
 #include <gamekid/cpu/opcode_decoder.h>
+#include <gamekid/cpu/opcode_table.h>
 #include <gamekid/utils/bytes.h>
 #include <gamekid/system.h>
 
@@ -25,6 +26,49 @@ namespace gamekid::tests {
         }
     }
 
+    TEST(OPCODE_DECODER, OPCODES_RUN_ON_THE_GIVEN_CPU) {
+        system built_with;
+        system other;
+        cpu::instruction_set set(built_with.cpu());
+        cpu::opcode_decoder decoder(set);
+
+        // ld b, c
+        other.cpu().C.store(0x42);
+        decoder.decode(0x41)->run(other.cpu());
+        ASSERT_EQ(0x42, other.cpu().B.load());
+
+        // set 3, b (the bit is a constant operand)
+        decoder.decode(0xD8CB)->run(other.cpu());
+        ASSERT_EQ(0x4A, other.cpu().B.load());
+
+        ASSERT_EQ(0, built_with.cpu().B.load());
+        ASSERT_EQ(&cpu::opcode_decoder::shared(), &cpu::opcode_decoder::shared());
+    }
+
+    TEST(OPCODE_DECODER, OPCODES_MATCH_THE_OPCODE_TABLE) {
+        const cpu::opcode_decoder& decoder = cpu::opcode_decoder::shared();
+        byte imm[4] = { 0 };
+
+        for (size_t index = 0; index < cpu::opcode_table::size; ++index) {
+            const cpu::opcode_table::entry& entry = cpu::opcode_table::entries[index];
+            const word opcode_word = index < 0x100 ? word(index) : word((index - 0x100) << 8 | cpu::opcode_table::cb_prefix);
+            const cpu::opcode* opcode = decoder.decode(opcode_word);
+
+            if (entry.type == cpu::opcode_table::kind::illegal) {
+                ASSERT_EQ(nullptr, opcode) << std::hex << opcode_word;
+            }
+
+            // the word of the prefix is the word of the first prefixed opcode
+            if (entry.type != cpu::opcode_table::kind::instruction) {
+                continue;
+            }
+
+            ASSERT_NE(nullptr, opcode) << "Missing opcode " << std::hex << opcode_word;
+            ASSERT_EQ(entry.size, opcode->full_size()) << opcode->to_str(imm);
+            ASSERT_EQ(entry.cycles, opcode->cycles) << opcode->to_str(imm);
+        }
+    }
+
     void decode_opcode_test(const cpu::opcode& opcode, cpu::opcode_decoder& decoder) {
         const word opcode_word =
             gamekid::utils::bytes::little_endian_decode<word>(opcode.value);
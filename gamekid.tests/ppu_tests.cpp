@@ -1,5 +1,9 @@
 #include "pch.h"
 #include "gamekid/io/video/tile.h"
+#include "gamekid/io/video/lcd.h"
+#include "gamekid/io/video/lcd_timing.h"
+#include "gamekid/io/video/palette_converter.h"
+#include "gamekid/io/io_registers.h"
 
 namespace gamekid::tests {
     
@@ -12,5 +16,256 @@ namespace gamekid::tests {
         ASSERT_EQ(0b00, t.get_color(1, 1));
         ASSERT_EQ(0b11, t.get_color(0, 1));
     }
-   
+
+    // Fills the video memory with a pattern, places two sprites and the window and turns the lcd on
+    void fill_raster_scene(io::video::lcd& lcd) {
+        for (word i = 0; i < io::video::vram_size; ++i) {
+            lcd.store(0x8000 + i, static_cast<byte>(i * 7 + (i >> 8)));
+        }
+
+        // two sprites, one behind the background
+        const byte sprites[] = { 40, 30, 3, 0x00, 44, 34, 5, 0x90 };
+        for (byte i = 0; i < sizeof(sprites); ++i) {
+            lcd.store(0xFE00 + i, sprites[i]);
+        }
+
+        lcd.store(BGP, 0xE4);
+        lcd.store(OBP0, 0xD2);
+        lcd.store(OBP1, 0x1B);
+        lcd.store(WY, 100);
+        lcd.store(WX, 87);
+        lcd.enabled(true);
+        lcd.store(LCDC, 0xF3);
+    }
+
+    // Changes the scroll registers in the middle of the lines of two frames of the scene
+    io::video::frame render_raster_effects(io::video::lcd& lcd) {
+        fill_raster_scene(lcd);
+
+        // two frames, the scroll changes every few cycles (in the middle of the lines)
+        for (dword cycle = 0; cycle < io::video::lcd_timing::cycles_per_frame * 2; cycle += 12) {
+            lcd.store(SCX, static_cast<byte>(cycle / 100));
+            if (cycle % 1000 == 0) lcd.store(SCY, static_cast<byte>(cycle / 1000));
+            if (cycle % 3000 == 0) lcd.store(LCDC, lcd.load(LCDC) ^ 0x20);
+            lcd.tick(12);
+        }
+
+        return lcd.screen();
+    }
+
+    TEST(PPU, DEFERRED_RENDER_MATCHES_SCANLINE) {
+        for (auto type : { io::video::renderer_type::per_line, io::video::renderer_type::pixel_fifo }) {
+            io::video::lcd scanline_lcd(io::video::render_mode::scanline, type);
+            io::video::lcd deferred_lcd(io::video::render_mode::deferred, type);
+            io::video::lcd async_lcd(io::video::render_mode::deferred_async, type);
+
+            const io::video::frame expected = render_raster_effects(scanline_lcd);
+
+            ASSERT_EQ(2, scanline_lcd.frame_count());
+            ASSERT_TRUE(expected == render_raster_effects(deferred_lcd));
+
+            // the async screen is a frame behind, the second frame is shown while the third one is drawn
+            render_raster_effects(async_lcd);
+            async_lcd.tick(io::video::lcd_timing::cycles_per_frame);
+            ASSERT_TRUE(expected == async_lcd.screen());
+        }
+    }
+
+    // Tile i is filled with color i % 4, the first row of the bg map is 0, 1, 2, 3, 0, 1...
+    void fill_striped_background(io::video::lcd& lcd) {
+        for (word tile = 0; tile < 4; ++tile) {
+            for (word row = 0; row < 8; ++row) {
+                lcd.store(0x8000 + tile * 16 + row * 2, (tile & 1) ? 0xFF : 0x00);
+                lcd.store(0x8000 + tile * 16 + row * 2 + 1, (tile & 2) ? 0xFF : 0x00);
+            }
+        }
+
+        for (word i = 0; i < 32 * 32; ++i) {
+            lcd.store(0x9800 + i, i % 4);
+        }
+
+        lcd.store(BGP, 0xE4);
+        lcd.enabled(true);
+        lcd.store(LCDC, 0x93);
+    }
+
+    TEST(PPU, FIFO_MATCHES_PER_LINE_ON_LINE_BOUNDARIES) {
+        io::video::lcd per_line(io::video::render_mode::scanline, io::video::renderer_type::per_line);
+        io::video::lcd fifo(io::video::render_mode::scanline, io::video::renderer_type::pixel_fifo);
+
+        for (io::video::lcd* lcd : { &per_line, &fifo }) {
+            fill_raster_scene(*lcd);
+
+            // the registers change in hblank, so both renderers see the same values for every line
+            for (dword cycle = 0; cycle < io::video::lcd_timing::cycles_per_frame; cycle += 4) {
+                if (cycle % io::video::lcd_timing::cycles_per_line == 400) {
+                    lcd->store(SCX, static_cast<byte>(cycle / 300));
+                    lcd->store(SCY, static_cast<byte>(cycle / 5000));
+                }
+
+                lcd->tick(4);
+            }
+
+            ASSERT_EQ(1, lcd->frame_count());
+        }
+
+        ASSERT_TRUE(per_line.screen() == fifo.screen());
+    }
+
+    TEST(PPU, WRITES_WHILE_THE_LCD_IS_OFF_DONT_GROW_THE_LOG) {
+        io::video::lcd scanline(io::video::render_mode::scanline, io::video::renderer_type::per_line);
+        io::video::lcd deferred(io::video::render_mode::deferred, io::video::renderer_type::per_line);
+        io::video::lcd async(io::video::render_mode::deferred_async, io::video::renderer_type::per_line);
+
+        for (io::video::lcd* lcd : { &scanline, &deferred, &async }) {
+            fill_striped_background(*lcd);
+            lcd->enabled(false);
+            const size_t off = lcd->heap_size();
+
+            // a game which fills the video memory many times with the lcd off
+            for (dword i = 0; i < 0x40000; ++i) {
+                lcd->store(0x8000 + i % io::video::vram_size, static_cast<byte>(i / 7));
+            }
+
+            ASSERT_LT(lcd->heap_size(), off + 0x2000 * sizeof(io::video::video_write));
+
+            lcd->enabled(true);
+            lcd->tick(io::video::lcd_timing::cycles_per_frame);
+            lcd->tick(io::video::lcd_timing::cycles_per_frame);
+        }
+
+        // the deferred renderers got every write
+        ASSERT_TRUE(scanline.screen() == deferred.screen());
+        ASSERT_TRUE(scanline.screen() == async.screen());
+    }
+
+    TEST(PPU, FIFO_PIXEL_TRANSFER_LENGTH) {
+        io::video::lcd lcd(io::video::render_mode::scanline, io::video::renderer_type::pixel_fifo);
+        fill_striped_background(lcd);
+
+        // 172 cycles without fine scroll, window and sprites
+        lcd.tick(io::video::lcd_timing::oam_search_cycles + 171);
+        ASSERT_EQ(3, lcd.load(STAT) & 0b11);
+        lcd.tick(1);
+        ASSERT_EQ(0, lcd.load(STAT) & 0b11);
+
+        // fine scroll makes the pixel transfer longer
+        lcd.store(SCX, 3);
+        lcd.tick(io::video::lcd_timing::cycles_per_line - 252 + io::video::lcd_timing::oam_search_cycles + 174);
+        ASSERT_EQ(3, lcd.load(STAT) & 0b11);
+        lcd.tick(1);
+        ASSERT_EQ(0, lcd.load(STAT) & 0b11);
+    }
+
+    TEST(PPU, DEFERRED_FIFO_STAT_MATCHES_SCANLINE) {
+        io::video::lcd scanline(io::video::render_mode::scanline, io::video::renderer_type::pixel_fifo);
+        io::video::lcd deferred(io::video::render_mode::deferred, io::video::renderer_type::pixel_fifo);
+        io::video::lcd async(io::video::render_mode::deferred_async, io::video::renderer_type::pixel_fifo);
+
+        for (io::video::lcd* lcd : { &scanline, &deferred, &async }) {
+            fill_striped_background(*lcd);
+
+            // a sprite on the first lines makes their pixel transfer longer
+            const byte sprite[] = { 16, 20, 1, 0x00 };
+            for (byte i = 0; i < sizeof(sprite); ++i) {
+                lcd->store(0xFE00 + i, sprite[i]);
+            }
+        }
+
+        // fine scroll which changes every line, the mode is checked at every cycle
+        for (dword cycle = 0; cycle < io::video::lcd_timing::cycles_per_line * 12; ++cycle) {
+            if (cycle % io::video::lcd_timing::cycles_per_line == 0) {
+                for (io::video::lcd* lcd : { &scanline, &deferred, &async }) {
+                    lcd->store(SCX, static_cast<byte>(cycle / io::video::lcd_timing::cycles_per_line));
+                }
+            }
+
+            ASSERT_EQ(scanline.load(STAT), deferred.load(STAT));
+            ASSERT_EQ(scanline.load(STAT), async.load(STAT));
+
+            for (io::video::lcd* lcd : { &scanline, &deferred, &async }) {
+                lcd->tick(1);
+            }
+        }
+    }
+
+    TEST(PPU, FIFO_MID_LINE_SCROLL) {
+        io::video::lcd per_line(io::video::render_mode::scanline, io::video::renderer_type::per_line);
+        io::video::lcd fifo(io::video::render_mode::scanline, io::video::renderer_type::pixel_fifo);
+        io::video::lcd deferred_fifo(io::video::render_mode::deferred, io::video::renderer_type::pixel_fifo);
+
+        for (io::video::lcd* lcd : { &per_line, &fifo, &deferred_fifo }) {
+            fill_striped_background(*lcd);
+
+            // scroll by a tile in the middle of the first line
+            lcd->tick(io::video::lcd_timing::oam_search_cycles + 90);
+            lcd->store(SCX, 8);
+            lcd->tick(io::video::lcd_timing::cycles_per_frame - io::video::lcd_timing::oam_search_cycles - 90);
+        }
+
+        const io::video::frame& line_screen = per_line.screen();
+        const io::video::frame& fifo_screen = fifo.screen();
+
+        // the left of the line was fetched before the write
+        ASSERT_EQ(0, fifo_screen[0]);
+        ASSERT_EQ(1, fifo_screen[8]);
+
+        // the right of the line was fetched after the write
+        ASSERT_EQ(3, line_screen[159]);
+        ASSERT_EQ(0, fifo_screen[159]);
+
+        ASSERT_TRUE(fifo_screen == deferred_fifo.screen());
+    }
+
+    TEST(PPU, LY_FOLLOWS_CYCLES) {
+        io::video::lcd lcd;
+        lcd.enabled(true);
+
+        ASSERT_EQ(0, lcd.load(LY));
+        lcd.tick(io::video::lcd_timing::cycles_per_line * 0x90);
+        ASSERT_EQ(0x90, lcd.load(LY));
+
+        lcd.enabled(false);
+        ASSERT_EQ(0, lcd.load(LY));
+    }
+
+    TEST(PPU, PALETTE_CONVERTER_MATCHES_LOOKUP) {
+        // 7 pixels wide, so the last 3 pixels are converted one by one
+        const byte pixels[] = { 0, 1, 2, 3, 3, 2, 1,  1, 1, 0, 0, 2, 2, 3 };
+        const std::array<word, 4> palette = io::video::rgb565_palette();
+        io::video::palette_converter<word> converter(palette);
+
+        std::array<word, 14> out{};
+        converter.convert(pixels, 7, 2, out.data());
+
+        for (size_t i = 0; i < out.size(); ++i) {
+            ASSERT_EQ(palette[pixels[i]], out[i]);
+        }
+    }
+
+    TEST(PPU, PALETTE_CONVERTER_SCALE) {
+        const byte pixels[] = { 0, 1, 2, 3, 1, 
+                                3, 2, 1, 0, 2 };
+        io::video::palette_converter<byte> converter(io::video::grayscale_palette());
+
+        constexpr int scale = 3;
+        std::array<byte, 5 * 2 * scale * scale> out{};
+        converter.convert(pixels, 5, 2, out.data(), scale);
+
+        for (int y = 0; y < 2 * scale; ++y) {
+            for (int x = 0; x < 5 * scale; ++x) {
+                ASSERT_EQ(io::video::grayscale_palette()[pixels[(y / scale) * 5 + x / scale]], out[y * 5 * scale + x]);
+            }
+        }
+    }
+
+    TEST(PPU, PACK_2BPP) {
+        const byte pixels[] = { 0, 1, 2, 3, 3, 3 };
+        std::array<byte, 2> out{};
+
+        io::video::pack_2bpp(pixels, sizeof(pixels), out.data());
+
+        ASSERT_EQ(0b11100100, out[0]);
+        ASSERT_EQ(0b1111, out[1]);
+    }
 }
@@ -0,0 +1,233 @@
+#include "pch.h"
+#include "gamekid/runner.h"
+#include "gamekid/rom/cartridge_header.h"
+#include "gamekid/rom/header_offsets.h"
+#include "gamekid/io/video/lcd_timing.h"
+#include "gamekid/io/video/video_state.h"
+#include "gamekid/io/audio/apu.h"
+#include "gamekid/io/io_registers.h"
+#include "gamekid/state/snapshot.h"
+#include "gamekid/utils/files.h"
+#include <filesystem>
+
+namespace gamekid::tests {
+
+    // a rom only cartridge which passes the boot rom's checks, and loops at 0x150
+    static rom::cartridge test_cartridge() {
+        std::vector<byte> rom(0x8000, 0);
+        std::copy(rom::nintendo_logo.begin(), rom::nintendo_logo.end(), rom.begin() + rom::header_offsets::logo.start);
+
+        const byte entry[] = { 0x00, 0xC3, 0x50, 0x01 };
+        std::copy(std::begin(entry), std::end(entry), rom.begin() + 0x100);
+
+        // jr -2
+        rom[0x150] = 0x18;
+        rom[0x151] = 0xFE;
+
+        rom::cartridge cart(std::move(rom));
+        byte checksum = cart.calculate_header_checksum();
+        std::vector<byte> data = cart.data();
+        data[rom::header_offsets::header_checksum.start] = checksum;
+        return rom::cartridge(std::move(data));
+    }
+
+    // DIV's internal 16 bit counter, from the saved timer
+    static word div_counter(runner& runner) {
+        state::snapshot image;
+        runner.save(image);
+        image.open_section(state::make_tag("TIMR"));
+
+        std::uint64_t cycle, div_reset;
+        image.read(cycle, div_reset);
+        return static_cast<word>(cycle - div_reset);
+    }
+
+    // the parts of the apu's saved state which don't depend on the time since power on: the registers,
+    // where the frame sequencer is, the mixer and the state of channel 2
+    static std::vector<byte> timeless_apu_state(runner& runner) {
+        state::snapshot image;
+        runner.save(image);
+        image.open_section(state::make_tag("APU "));
+
+        std::array<byte, 0x30> registers;
+        std::uint64_t cycle, synth_cycle, next_sequencer_cycle;
+        std::vector<io::audio::audio_write> writes;
+        byte sequencer_step, panning, master_volume;
+        bool powered;
+        std::array<std::array<int, 2>, 4> weights;
+        io::audio::square_channel square1(true), square2(false);
+
+        image.read(registers, cycle);
+        image.read_vector(writes, [](state::snapshot& from, io::audio::audio_write& write) {
+            from.read(write.cycle, write.address, write.value);
+        });
+        image.read(synth_cycle, next_sequencer_cycle, sequencer_step);
+        image.read(powered, panning, master_volume, weights);
+        square1.load(image);
+        square2.load(image);
+
+        state::snapshot timeless;
+        timeless.write(registers, next_sequencer_cycle - cycle, sequencer_step);
+        timeless.write(powered, panning, master_volume, weights);
+        timeless.write_vector(writes, [](state::snapshot& to, const io::audio::audio_write& write) {
+            to.write(write.address, write.value);
+        });
+        square2.save(timeless);
+        return std::vector<byte>(timeless.data(), timeless.data() + timeless.size());
+    }
+
+    TEST(RUNNER, SKIPPING_THE_BOOT_ROM_LEAVES_THE_SAME_STATE) {
+        runner booted(test_cartridge());
+
+        while (booted.cpu().PC.load() != 0x100) {
+            booted.next();
+        }
+
+        runner skipped(test_cartridge());
+        skipped.skip_boot_rom();
+
+        for (runner* current : { &booted, &skipped }) {
+            current->scheduler().sync_all();
+        }
+
+        ASSERT_EQ(booted.cpu().AF.load(), skipped.cpu().AF.load());
+        ASSERT_EQ(booted.cpu().BC.load(), skipped.cpu().BC.load());
+        ASSERT_EQ(booted.cpu().DE.load(), skipped.cpu().DE.load());
+        ASSERT_EQ(booted.cpu().HL.load(), skipped.cpu().HL.load());
+        ASSERT_EQ(booted.cpu().SP.load(), skipped.cpu().SP.load());
+        ASSERT_EQ(booted.cpu().PC.load(), skipped.cpu().PC.load());
+        ASSERT_EQ(booted.cpu()._interrupts_enabled, skipped.cpu()._interrupts_enabled);
+
+        // the rom, the video memory, the ram, the oam and the io registers
+        ASSERT_EQ(booted.dump(0x0000, 0xFE00), skipped.dump(0x0000, 0xFE00));
+        ASSERT_EQ(booted.dump(0xFE00, 0xA0), skipped.dump(0xFE00, 0xA0));
+        ASSERT_EQ(booted.dump(0xFF00, 0x100), skipped.dump(0xFF00, 0x100));
+
+        // the timing: DIV and the lcd's place in the frame
+        ASSERT_EQ(booted.dump(DIV, 1), skipped.dump(DIV, 1));
+        ASSERT_EQ(booted.dump(LY, 1), skipped.dump(LY, 1));
+        ASSERT_EQ(booted.dump(STAT, 1), skipped.dump(STAT, 1));
+        ASSERT_EQ(booted.lcd().cycles_to_frame_end(), skipped.lcd().cycles_to_frame_end());
+        ASSERT_EQ(div_counter(booted), div_counter(skipped));
+        ASSERT_EQ(timeless_apu_state(booted), timeless_apu_state(skipped));
+
+        // what may differ: the cycles and the frames since power on (the boot rom runs 300 frames), the phase of
+        // channel 1, which played the boot sound and is silent at a volume of 0 until it is triggered again,
+        // and the wave channel's position and the noise channel's shift register, which run while the channels
+        // are off and are reset when they are triggered
+
+        // and they go on the same way
+        for (int frame = 0; frame < 3; ++frame) {
+            booted.run_frame();
+            skipped.run_frame();
+            ASSERT_EQ(booted.cpu().PC.load(), skipped.cpu().PC.load());
+            ASSERT_EQ(booted.dump(0xFF00, 0x100), skipped.dump(0xFF00, 0x100));
+        }
+
+        ASSERT_THROW(skipped.skip_boot_rom(), std::exception);
+    }
+
+    TEST(RUNNER, THE_SAME_RUN_SAVES_THE_SAME_IMAGE) {
+        std::vector<state::snapshot> images(2);
+
+        for (state::snapshot& image : images) {
+            // the records are written field by field, there are no padding bytes that differ between runs
+            runner current(test_cartridge());
+            current.skip_boot_rom();
+            current.joypad().post({ 2, io::input_time::frame, io::joypad_button::start, true });
+
+            for (int frame = 0; frame < 5; ++frame) {
+                current.run_frame();
+                current.lcd().store(SCX, static_cast<byte>(frame));
+                current.apu().store(NR_12, 0xF0);
+                current.apu().store(NR_14, 0x80);
+            }
+
+            current.save(image);
+        }
+
+        ASSERT_EQ(images[0].size(), images[1].size());
+        ASSERT_TRUE(std::equal(images[0].data(), images[0].data() + images[0].size(), images[1].data()));
+    }
+
+    TEST(RUNNER, A_FORK_SHARES_THE_VIDEO_MEMORY_UNTIL_IT_IS_WRITTEN) {
+        runner parent(test_cartridge());
+        parent.skip_boot_rom();
+        parent.run_frame();
+
+        // the video memory is counted by the runner which holds it alone
+        const size_t alone = parent.lcd().heap_size();
+        std::unique_ptr<runner> child = parent.fork();
+        const size_t child_lcd = child->lcd().heap_size();
+        ASSERT_GE(alone, parent.lcd().heap_size() + io::video::vram_size);
+        ASSERT_GE(alone, child_lcd + io::video::vram_size);
+
+        state::snapshot parent_image, child_image;
+        parent.save(parent_image);
+        child->save(child_image);
+        ASSERT_EQ(parent_image.size(), child_image.size());
+        ASSERT_TRUE(std::equal(parent_image.data(), parent_image.data() + parent_image.size(), child_image.data()));
+
+        // the child copies the video memory when it writes it, the parent keeps its own
+        const std::vector<byte> tiles = parent.dump(0x8000, 0x10);
+        child->lcd().store(0x8000, static_cast<byte>(~tiles[0]));
+        ASSERT_GE(child->lcd().heap_size(), child_lcd + io::video::vram_size);
+        ASSERT_EQ(tiles, parent.dump(0x8000, 0x10));
+        ASSERT_EQ(static_cast<byte>(~tiles[0]), child->dump(0x8000, 1)[0]);
+    }
+
+    TEST(RUNNER, WARM_START_LOADS_THE_STATE_OF_AN_EARLIER_RUN) {
+        const std::filesystem::path directory = std::filesystem::temp_directory_path() / "gamekid_warm_cache_tests";
+        std::filesystem::remove_all(directory);
+        const state::warm_cache cache(directory.string());
+
+        runner first(test_cartridge());
+        first.skip_boot_rom();
+        ASSERT_FALSE(first.warm_start(cache, 20));
+
+        runner second(test_cartridge());
+        second.skip_boot_rom();
+        ASSERT_TRUE(second.warm_start(cache, 20));
+
+        state::snapshot ran, loaded;
+        first.save(ran);
+        second.save(loaded);
+        ASSERT_EQ(ran.size(), loaded.size());
+        ASSERT_TRUE(std::equal(ran.data(), ran.data() + ran.size(), loaded.data()));
+
+        // another configuration, amount of frames or start is another entry
+        runner other(test_cartridge());
+        other.skip_boot_rom();
+        ASSERT_FALSE(other.warm_start(cache, 20, "movie.inp"));
+
+        runner booted(test_cartridge());
+        ASSERT_FALSE(booted.warm_start(cache, 20));
+
+        runner changed(test_cartridge());
+        changed.skip_boot_rom();
+        changed.cpu().B.store(changed.cpu().B.load() ^ 0xFF);
+        ASSERT_FALSE(changed.warm_start(cache, 20));
+
+        // the render mode isn't part of the state, a runner which draws another way loads the same entry
+        runner deferred(test_cartridge());
+        deferred.lcd().mode(io::video::render_mode::deferred);
+        deferred.skip_boot_rom();
+        ASSERT_TRUE(deferred.warm_start(cache, 20));
+        ASSERT_TRUE(deferred.lcd().mode() == io::video::render_mode::deferred);
+
+        // the entries of another core version are run again and replaced
+        for (const auto& file : std::filesystem::directory_iterator(directory)) {
+            std::vector<byte> entry = utils::files::read_file(file.path().string());
+            entry[sizeof(state::tag)] ^= 0xFF;
+            utils::files::write_file(file.path().string(), entry.data(), entry.size());
+        }
+
+        for (bool stored : { false, true }) {
+            runner current(test_cartridge());
+            current.skip_boot_rom();
+            ASSERT_EQ(stored, current.warm_start(cache, 20));
+        }
+
+        std::filesystem::remove_all(directory);
+    }
+}
@@ -0,0 +1,109 @@
+#include "pch.h"
+#include "gamekid/io/scheduler.h"
+#include "gamekid/io/io_registers.h"
+#include "gamekid/io/interrupts.h"
+#include "gamekid/io/video/lcd_timing.h"
+#include "gamekid/memory/gameboy_memory_map.h"
+#include "gamekid/memory/memory.h"
+#include "test_rom_map.h"
+
+namespace gamekid::tests {
+    namespace lcd_timing = io::video::lcd_timing;
+
+    struct scheduled_system {
+        test_rom_map rom;
+        io::video::lcd lcd;
+        io::audio::apu apu;
+        io::timer timer;
+        io::serial serial;
+        io::joypad_input joypad;
+        byte interrupts = 0;
+        io::scheduler scheduler{ lcd, apu, timer, serial, joypad, [this](byte interrupt) { interrupts |= interrupt; } };
+        memory::gameboy_memory_map memory_map{ rom, scheduler };
+        memory::memory memory{ memory_map };
+    };
+
+    TEST(SCHEDULER, LCD_RUNS_WHEN_OBSERVED) {
+        scheduled_system sys;
+        sys.memory.store_byte(LCDC, 0x80);
+
+        for (dword i = 0; i < lcd_timing::cycles_per_line * 10; i += 4) {
+            sys.scheduler.advance(4);
+        }
+
+        // nothing was run yet
+        ASSERT_EQ(0, sys.lcd.ly());
+        ASSERT_EQ(0, sys.scheduler.lcd_sync().syncs());
+
+        ASSERT_EQ(10, sys.memory.load_byte(LY));
+        ASSERT_EQ(1, sys.scheduler.lcd_sync().syncs());
+
+        // the vram is synced too
+        sys.scheduler.advance(lcd_timing::cycles_per_line);
+        sys.memory.store_byte(0x8000, 0x12);
+        ASSERT_EQ(11, sys.lcd.ly());
+        ASSERT_EQ(0x12, sys.memory.load_byte(0x8000));
+        ASSERT_EQ(2, sys.scheduler.lcd_sync().syncs());
+    }
+
+    TEST(SCHEDULER, FRAME_END_IS_AN_EVENT) {
+        scheduled_system sys;
+        sys.memory.store_byte(LCDC, 0x80);
+        ASSERT_EQ(lcd_timing::cycles_per_frame, sys.scheduler.lcd_sync().next_event());
+
+        for (dword i = 0; i < lcd_timing::cycles_per_frame * 3; i += 4) {
+            sys.scheduler.advance(4);
+        }
+
+        // the lcd was woken once per frame
+        ASSERT_EQ(3, sys.lcd.frame_count());
+        ASSERT_EQ(3, sys.scheduler.lcd_sync().syncs());
+
+        // the lcd is off, there is no event
+        sys.memory.store_byte(LCDC, 0x00);
+        ASSERT_EQ(io::catch_up::never, sys.scheduler.lcd_sync().next_event());
+    }
+
+    TEST(SCHEDULER, TIMER_OVERFLOW_IS_AN_EVENT) {
+        scheduled_system sys;
+        sys.memory.store_byte(TIMA, 0xFE);
+        sys.memory.store_byte(TAC, 0x05);
+
+        sys.scheduler.advance(16);
+        ASSERT_EQ(0, sys.interrupts);
+        ASSERT_EQ(0, sys.scheduler.timer_sync().syncs());
+
+        sys.scheduler.advance(16);
+        ASSERT_EQ(io::interrupts::timer, sys.interrupts);
+        ASSERT_EQ(1, sys.scheduler.timer_sync().syncs());
+        ASSERT_EQ(0, sys.memory.load_byte(TIMA));
+    }
+
+    TEST(SCHEDULER, APU_RUNS_AT_SYNC) {
+        scheduled_system sys;
+        sys.memory.store_byte(NR_52, 0x80);
+
+        for (dword i = 0; i < lcd_timing::cycles_per_frame; i += 4) {
+            sys.scheduler.advance(4);
+        }
+
+        ASSERT_EQ(0, sys.scheduler.apu_sync().syncs());
+        sys.scheduler.sync_all();
+        sys.apu.flush();
+        ASSERT_EQ(1, sys.scheduler.apu_sync().syncs());
+        ASSERT_FALSE(sys.apu.samples().empty());
+    }
+
+    TEST(SCHEDULER, A_LONG_CATCH_UP_LOSES_NO_CYCLES) {
+        std::uint64_t master_cycle = 0;
+        std::uint64_t ran = 0;
+        io::catch_up sync{ master_cycle, [&ran](dword cycles) { ran += cycles; },
+            [] { return io::catch_up::never; } };
+
+        master_cycle = 3 * static_cast<std::uint64_t>(UINT32_MAX) + 5;
+        sync.sync();
+
+        ASSERT_EQ(master_cycle, ran);
+        ASSERT_EQ(1, sync.syncs());
+    }
+}
@@ -0,0 +1,390 @@
+#include "pch.h"
+#include "gamekid/state/snapshot.h"
+#include "gamekid/state/rewind_buffer.h"
+#include "gamekid/io/scheduler.h"
+#include "gamekid/io/io_registers.h"
+#include "gamekid/io/video/lcd_timing.h"
+#include "gamekid/memory/gameboy_memory_map.h"
+#include "gamekid/memory/memory.h"
+#include "test_rom_map.h"
+
+namespace gamekid::tests {
+    using state::snapshot;
+    namespace lcd_timing = io::video::lcd_timing;
+
+    struct snapshot_system {
+        test_rom_map rom;
+        io::video::lcd lcd;
+        io::audio::apu apu;
+        io::timer timer;
+        io::serial serial;
+        io::joypad_input joypad;
+        byte interrupts = 0;
+        io::scheduler scheduler{ lcd, apu, timer, serial, joypad, [this](byte interrupt) { interrupts |= interrupt; } };
+        memory::gameboy_memory_map memory_map{ rom, scheduler };
+        memory::memory memory{ memory_map };
+
+        void save(snapshot& snapshot) {
+            scheduler.sync_all();
+            snapshot.clear();
+            snapshot.begin_section(state::make_tag("TEST"));
+            memory_map.save(snapshot);
+            snapshot.write(interrupts);
+            snapshot.end_section();
+            scheduler.save(snapshot);
+        }
+
+        void load(snapshot& snapshot) {
+            snapshot.rewind();
+            snapshot.open_section(state::make_tag("TEST"));
+            memory_map.load(snapshot);
+            snapshot.read(interrupts);
+            snapshot.close_section();
+            scheduler.load(snapshot);
+        }
+
+        // what the cpu would see in the next lines
+        std::vector<byte> trace(dword lines) {
+            std::vector<byte> result;
+
+            for (dword line = 0; line < lines; ++line) {
+                for (dword cycle = 0; cycle < lcd_timing::cycles_per_line; cycle += 4) {
+                    scheduler.advance(4);
+                }
+
+                for (word address : { LY, STAT, DIV, TIMA, NR_52 }) {
+                    result.push_back(memory.load_byte(address));
+                }
+
+                result.push_back(memory.load_byte(0xC000));
+                result.push_back(interrupts);
+                memory.store_byte(0xC000, static_cast<byte>(line));
+            }
+
+            return result;
+        }
+    };
+
+    TEST(STATE, SNAPSHOT_READS_WHAT_WAS_WRITTEN) {
+        snapshot image;
+        image.clear();
+        image.write(dword(0x12345678), byte(0x9A), true);
+        image.write_vector(std::vector<word>{ 1, 2, 3 });
+
+        dword number;
+        byte value;
+        bool flag;
+        std::vector<word> values;
+
+        image.rewind();
+        image.read(number, value, flag);
+        image.read_vector(values);
+
+        ASSERT_EQ(0x12345678, number);
+        ASSERT_EQ(0x9A, value);
+        ASSERT_TRUE(flag);
+        ASSERT_EQ((std::vector<word>{ 1, 2, 3 }), values);
+        ASSERT_THROW(image.read(value), std::exception);
+
+        // a new image reuses the buffer
+        const byte* buffer = image.data();
+        const size_t size = image.size();
+        image.clear();
+        image.write(dword(0), byte(0), false);
+        image.write_vector(std::vector<word>{ 4, 5, 6 });
+        ASSERT_EQ(buffer, image.data());
+        ASSERT_EQ(size, image.size());
+    }
+
+    TEST(STATE, SECTIONS_ARE_FOUND_BY_TAG) {
+        snapshot image;
+        image.clear();
+        image.begin_section(state::make_tag("AAAA"));
+        image.write(dword(1));
+        image.end_section();
+        image.begin_section(state::make_tag("BBBB"));
+        image.write(dword(2), dword(3));
+        image.end_section();
+
+        dword first, second;
+        image.rewind();
+        image.open_section(state::make_tag("BBBB"));
+        image.read(first);
+        ASSERT_THROW(image.close_section(), std::exception);
+        image.read(second);
+        image.close_section();
+        ASSERT_EQ(2, first);
+        ASSERT_EQ(3, second);
+
+        // a section which is not read is skipped
+        image.open_section(state::make_tag("AAAA"));
+        image.read(first);
+        image.close_section();
+        ASSERT_EQ(1, first);
+
+        ASSERT_THROW(image.open_section(state::make_tag("CCCC")), std::exception);
+    }
+
+    TEST(STATE, INVALID_VALUES_ARE_NOT_READ) {
+        enum class choice : byte { first, second };
+
+        snapshot image;
+        image.clear();
+        image.write(byte(2), byte(2), std::uint32_t(0x7FFFFFFF));
+
+        bool flag;
+        choice value;
+        std::vector<dword> values;
+
+        image.rewind();
+        ASSERT_THROW(image.read(flag), std::exception);
+        ASSERT_THROW(image.read_enum(value, choice::second), std::exception);
+
+        // a vector which is longer than the image is not allocated
+        ASSERT_THROW(image.read_vector(values), std::exception);
+        ASSERT_TRUE(values.empty());
+
+        image.clear();
+        image.write(true, choice::second);
+        image.rewind();
+        image.read(flag);
+        image.read_enum(value, choice::second);
+        ASSERT_TRUE(flag);
+        ASSERT_TRUE(choice::second == value);
+    }
+
+    TEST(STATE, INDICES_OUT_OF_THEIR_TABLES_ARE_NOT_READ) {
+        // a square channel with the duty 4 is after the four patterns
+        snapshot image;
+        const auto write_square = [&image](byte duty) {
+            image.clear();
+            image.write(true, dword(0), false, byte(0xF0), byte(15), byte(0));
+            image.write(duty, byte(0), word(0x700), dword(100));
+            image.write(byte(0), false, byte(0), word(0x700));
+            image.rewind();
+        };
+
+        io::audio::square_channel channel(true);
+        write_square(4);
+        ASSERT_THROW(channel.load(image), std::exception);
+        write_square(3);
+        channel.load(image);
+
+        // a wave channel position after its 32 samples
+        image.clear();
+        image.write(true, true, dword(0), false, byte(0), word(0x700), dword(100), byte(32), std::array<byte, 16>{});
+
+        io::audio::wave_channel wave;
+        image.rewind();
+        ASSERT_THROW(wave.load(image), std::exception);
+
+        // an lcd cycle after the end of the frame
+        image.clear();
+        image.write(true, false, dword(lcd_timing::cycles_per_frame), dword(0), dword(0));
+
+        io::video::lcd lcd;
+        image.rewind();
+        ASSERT_THROW(lcd.load(image), std::exception);
+    }
+
+    TEST(STATE, OTHER_VERSIONS_ARE_NOT_READ) {
+        snapshot image;
+        image.clear();
+        image.rewind();
+
+        snapshot other;
+        other.write(snapshot::magic, snapshot::version + 1);
+        ASSERT_THROW(other.rewind(), std::exception);
+
+        snapshot garbage;
+        garbage.write(dword(0x12345678), snapshot::version);
+        ASSERT_THROW(garbage.rewind(), std::exception);
+    }
+
+    TEST(STATE, COMPONENTS_RESUME_FROM_A_SNAPSHOT) {
+        snapshot_system sys;
+        sys.memory.store_byte(LCDC, 0x80);
+        sys.memory.store_byte(TAC, 0x05);
+        sys.memory.store_byte(TMA, 0xF0);
+        sys.memory.store_byte(NR_52, 0x80);
+        sys.memory.store_byte(NR_51, 0xFF);
+        sys.memory.store_byte(NR_50, 0x77);
+        sys.memory.store_byte(NR_11, 0x3E);
+        sys.memory.store_byte(NR_12, 0xF0);
+        sys.memory.store_byte(NR_14, 0xC0);
+        sys.trace(200);
+
+        snapshot image;
+        sys.save(image);
+        sys.apu.clear_samples();
+
+        const std::vector<byte> played = sys.trace(300);
+        sys.apu.flush();
+        const std::vector<io::audio::sample> samples = sys.apu.samples();
+        ASSERT_FALSE(samples.empty());
+
+        // the samples are not a part of the state
+        sys.load(image);
+        sys.apu.clear_samples();
+
+        ASSERT_EQ(played, sys.trace(300));
+        sys.apu.flush();
+        ASSERT_EQ(samples, sys.apu.samples());
+    }
+
+    // The lcd of a scene with mid line scrolling, from the given cycle to the other one
+    static void run_scrolling_lcd(io::video::lcd& lcd, dword from_cycle, dword to_cycle) {
+        if (from_cycle == 0) {
+            for (word i = 0; i < io::video::vram_size; ++i) {
+                lcd.store(0x8000 + i, static_cast<byte>(i * 7 + (i >> 8)));
+            }
+
+            const byte sprites[] = { 40, 30, 3, 0x00, 44, 34, 5, 0x90 };
+            for (byte i = 0; i < sizeof(sprites); ++i) {
+                lcd.store(0xFE00 + i, sprites[i]);
+            }
+
+            lcd.store(BGP, 0xE4);
+            lcd.store(WY, 100);
+            lcd.store(WX, 87);
+            lcd.enabled(true);
+            lcd.store(LCDC, 0xF3);
+        }
+
+        for (dword cycle = from_cycle; cycle < to_cycle; cycle += 4) {
+            if (cycle % 52 == 0) lcd.store(SCX, static_cast<byte>(cycle / 52));
+            if (cycle % 3000 == 0) lcd.store(0x9800 + (cycle / 3000) % 0x400, static_cast<byte>(cycle));
+            lcd.tick(4);
+        }
+    }
+
+    TEST(STATE, LCD_STATE_LOADS_INTO_ANY_BACKEND) {
+        using io::video::render_mode;
+        using io::video::renderer_type;
+
+        const std::pair<render_mode, renderer_type> setups[] = {
+            { render_mode::scanline, renderer_type::per_line },
+            { render_mode::scanline, renderer_type::pixel_fifo },
+            { render_mode::deferred, renderer_type::per_line },
+            { render_mode::deferred, renderer_type::pixel_fifo },
+            { render_mode::deferred_async, renderer_type::pixel_fifo },
+        };
+
+        // in the middle of a line of the second frame
+        const dword saved_cycle = lcd_timing::cycles_per_frame + 30002;
+        const dword vblank_cycle = lcd_timing::cycles_per_frame + lcd_timing::vblank_start + 100;
+
+        for (const auto& saved_setup : setups) {
+            io::video::lcd saved_lcd(saved_setup.first, saved_setup.second);
+            run_scrolling_lcd(saved_lcd, 0, saved_cycle);
+
+            snapshot image;
+            image.clear();
+            saved_lcd.save(image);
+
+            for (const auto& setup : setups) {
+                io::video::lcd expected(setup.first, setup.second);
+                run_scrolling_lcd(expected, 0, saved_cycle);
+
+                io::video::lcd loaded(setup.first, setup.second);
+                image.rewind();
+                loaded.load(image);
+
+                // the lcd keeps its own mode and backend
+                ASSERT_TRUE(setup.first == loaded.mode());
+                ASSERT_TRUE(setup.second == loaded.backend());
+
+                for (dword cycle = saved_cycle; cycle < vblank_cycle; cycle += 4) {
+                    ASSERT_EQ(expected.load(STAT), loaded.load(STAT));
+                    run_scrolling_lcd(expected, cycle, cycle + 4);
+                    run_scrolling_lcd(loaded, cycle, cycle + 4);
+                }
+
+                // the frame the state was saved in is drawn whole, the async screen shows it a frame later
+                if (setup.first == render_mode::deferred_async) {
+                    run_scrolling_lcd(expected, vblank_cycle, vblank_cycle + lcd_timing::cycles_per_frame);
+                    run_scrolling_lcd(loaded, vblank_cycle, vblank_cycle + lcd_timing::cycles_per_frame);
+                }
+
+                ASSERT_TRUE(expected.screen() == loaded.screen());
+                ASSERT_EQ(expected.frame_count(), loaded.frame_count());
+            }
+        }
+    }
+
+    // images which change a little every frame and sometimes change their size
+    static std::vector<snapshot> frame_images(dword count) {
+        std::vector<snapshot> images(count);
+        std::vector<byte> memory(0x2000);
+
+        for (dword frame = 0; frame < count; ++frame) {
+            memory[(frame * 97) % memory.size()] = static_cast<byte>(frame);
+            memory[(frame * 31 + 7) % memory.size()] ^= 0xFF;
+
+            if (frame % 7 == 0) {
+                memory.resize(memory.size() + 16, static_cast<byte>(frame));
+            }
+
+            images[frame].clear();
+            images[frame].write_vector(memory);
+        }
+
+        return images;
+    }
+
+    static bool same(const snapshot& left, const snapshot& right) {
+        return left.size() == right.size() && std::equal(left.data(), left.data() + left.size(), right.data());
+    }
+
+    TEST(STATE, REWIND_GOES_BACK_FRAME_BY_FRAME) {
+        const std::vector<snapshot> images = frame_images(100);
+        state::rewind_buffer rewind(1 << 20, 10);
+
+        for (const snapshot& image : images) {
+            rewind.push(image);
+        }
+
+        ASSERT_EQ(100, rewind.frames());
+
+        // the deltas are much smaller than the images
+        ASSERT_LT(rewind.used(), images.back().size() * 20);
+
+        // going back, then forward again from an older frame
+        snapshot image;
+        ASSERT_TRUE(rewind.pop());
+        ASSERT_TRUE(rewind.pop());
+        rewind.push(images[0]);
+        ASSERT_TRUE(rewind.latest(image));
+        ASSERT_TRUE(same(images[0], image));
+        ASSERT_TRUE(rewind.pop());
+        ASSERT_TRUE(rewind.latest(image));
+        ASSERT_TRUE(same(images[97], image));
+        rewind.push(images[98]);
+        rewind.push(images[99]);
+
+        for (size_t frame = images.size(); frame > 0; --frame) {
+            ASSERT_TRUE(rewind.latest(image));
+            ASSERT_TRUE(same(images[frame - 1], image));
+            ASSERT_TRUE(rewind.pop());
+        }
+
+        ASSERT_FALSE(rewind.latest(image));
+        ASSERT_FALSE(rewind.pop());
+    }
+
+    TEST(STATE, REWIND_DROPS_THE_OLDEST_FRAMES) {
+        const std::vector<snapshot> images = frame_images(300);
+        state::rewind_buffer rewind(8 * 1024, 5);
+        snapshot image;
+
+        for (size_t frame = 0; frame < images.size(); ++frame) {
+            rewind.push(images[frame]);
+            ASSERT_LE(rewind.used(), rewind.budget());
+            ASSERT_TRUE(rewind.latest(image));
+            ASSERT_TRUE(same(images[frame], image));
+        }
+
+        ASSERT_GT(rewind.frames(), 0);
+        ASSERT_LT(rewind.frames(), images.size());
+    }
+}
@@ -0,0 +1,119 @@
+#include "pch.h"
+#include "gamekid/io/timer.h"
+#include "gamekid/io/io_registers.h"
+
+namespace gamekid::tests {
+    using io::timer;
+
+    TEST(TIMER, DIV_COUNTS_AND_RESETS) {
+        timer timer;
+        timer.tick(256 * 5 + 100);
+        ASSERT_EQ(5, timer.load(DIV));
+
+        timer.store(DIV, 0x12);
+        ASSERT_EQ(0, timer.load(DIV));
+
+        timer.tick(256);
+        ASSERT_EQ(1, timer.load(DIV));
+    }
+
+    TEST(TIMER, TIMA_COUNTS_THE_SELECTED_BIT) {
+        timer timer;
+        ASSERT_EQ(timer::never, timer.next_overflow());
+
+        // 16 cycles
+        timer.store(TAC, 0x05);
+        timer.tick(160);
+        ASSERT_EQ(10, timer.load(TIMA));
+
+        // 4096 Hz, the counter is at 160 so the first edge is at 1024
+        timer.store(TAC, 0x04);
+        timer.tick(1024 - 160 - 1);
+        ASSERT_EQ(10, timer.load(TIMA));
+        timer.tick(1);
+        ASSERT_EQ(11, timer.load(TIMA));
+
+        // disabled
+        timer.store(TAC, 0x00);
+        timer.tick(4096);
+        ASSERT_EQ(11, timer.load(TIMA));
+        ASSERT_EQ(0xF8, timer.load(TAC));
+    }
+
+    TEST(TIMER, OVERFLOW_RELOADS_TMA) {
+        timer timer;
+        timer.store(TMA, 0xF0);
+        timer.store(TIMA, 0xFE);
+        timer.store(TAC, 0x05);
+        ASSERT_EQ(32, timer.next_overflow());
+
+        ASSERT_FALSE(timer.tick(31));
+        ASSERT_EQ(0xFF, timer.load(TIMA));
+        ASSERT_TRUE(timer.tick(1));
+        ASSERT_EQ(0xF0, timer.load(TIMA));
+
+        // the next overflow is 16 increments later
+        ASSERT_EQ(32 + 16 * 16, timer.next_overflow());
+
+        // reading late still sees the reload
+        timer.tick(16 * 16 + 16 * 3);
+        ASSERT_EQ(0xF3, timer.load(TIMA));
+    }
+
+    TEST(TIMER, WRITES_RESCHEDULE_THE_OVERFLOW) {
+        timer timer;
+        timer.store(TAC, 0x05);
+        ASSERT_EQ(256 * 16, timer.next_overflow());
+
+        timer.tick(100);
+        timer.store(TIMA, 0xFF);
+        ASSERT_EQ(112, timer.next_overflow());
+
+        timer.store(DIV, 0);
+        ASSERT_EQ(100 + 16, timer.next_overflow());
+    }
+
+    TEST(TIMER, DIV_RESET_FALLING_EDGE) {
+        timer timer;
+        timer.store(TAC, 0x05);
+
+        // bit 3 of the counter is set
+        timer.tick(8);
+        ASSERT_EQ(0, timer.load(TIMA));
+        timer.store(DIV, 0);
+        ASSERT_EQ(1, timer.load(TIMA));
+
+        // bit 3 is clear, no edge
+        timer.tick(4);
+        timer.store(DIV, 0);
+        ASSERT_EQ(1, timer.load(TIMA));
+    }
+
+    TEST(TIMER, TAC_CHANGE_FALLING_EDGE) {
+        timer timer;
+        timer.store(TAC, 0x05);
+        timer.tick(8);
+
+        // from bit 3 (set) to bit 9 (clear)
+        timer.store(TAC, 0x04);
+        ASSERT_EQ(1, timer.load(TIMA));
+
+        // disabling while the selected bit is set
+        timer.store(TAC, 0x05);
+        timer.store(TAC, 0x01);
+        ASSERT_EQ(2, timer.load(TIMA));
+    }
+
+    TEST(TIMER, FALLING_EDGE_OVERFLOW) {
+        timer timer;
+        timer.store(TMA, 0x80);
+        timer.store(TIMA, 0xFF);
+        timer.store(TAC, 0x05);
+        timer.tick(8);
+
+        timer.store(DIV, 0);
+        ASSERT_EQ(0x80, timer.load(TIMA));
+        ASSERT_TRUE(timer.tick(4));
+        ASSERT_EQ(0x80, timer.load(TIMA));
+    }
+}
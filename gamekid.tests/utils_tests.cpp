@@ -2,6 +2,8 @@
 #include <gamekid/utils/str.h>
 #include <gamekid/utils/bytes.h>
 #include <gamekid/utils/bits.h>
+#include <gamekid/utils/spsc_ring.h>
+#include <thread>
 #include "test_tools.h"
 
 namespace gamekid::tests {
@@ -61,4 +63,64 @@ namespace gamekid::tests {
         ASSERT_EQ(true, utils::bits::check_carry_down(0x00, 0xFF, 7));
         ASSERT_EQ(false, utils::bits::check_carry_down(0xFF, 0xFE, 8));
     }
-}
\ No newline at end of file
+
+    TEST(UTILS, SPSC_RING_WRAP_AROUND) {
+        utils::spsc_ring<int> ring(5);
+        ASSERT_EQ(8u, ring.capacity());
+
+        const int first[] = { 1, 2, 3, 4, 5, 6 };
+        ASSERT_EQ(6u, ring.write(first, 6));
+
+        int out[8];
+        ASSERT_EQ(4u, ring.read(out, 4));
+
+        // 2 left, 6 free, the write wraps around the end
+        const int second[] = { 7, 8, 9, 10, 11, 12, 13 };
+        ASSERT_EQ(6u, ring.write(second, 7));
+        ASSERT_EQ(8u, ring.size());
+
+        ASSERT_EQ(8u, ring.read(out, 8));
+        assert_equals<std::vector<int>>({ 5, 6, 7, 8, 9, 10, 11, 12 }, std::vector<int>(out, out + 8));
+        ASSERT_FALSE(ring.pop(out[0]));
+    }
+
+    TEST(UTILS, SPSC_RING_THREADS) {
+        utils::spsc_ring<dword> ring(64);
+        const dword count = 20000;
+
+        std::thread producer([&ring]() {
+            for (dword i = 0; i < count; ) {
+                if (ring.push(i)) {
+                    ++i;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        // the items arrive in order, none lost and none repeated. Every item is taken so the producer ends,
+        // the first one out of order is checked after it joined
+        dword mismatches = 0;
+        dword first_expected = 0, first_value = 0;
+
+        for (dword expected = 0; expected < count; ) {
+            dword value;
+
+            if (!ring.pop(value)) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (value != expected && mismatches++ == 0) {
+                first_expected = expected;
+                first_value = value;
+            }
+
+            ++expected;
+        }
+
+        producer.join();
+        ASSERT_EQ(first_expected, first_value);
+        ASSERT_EQ(0, mismatches);
+    }
+}
@@ -0,0 +1,145 @@
+#include "batch_runner.h"
+#include "input_movie.h"
+#include <gamekid/runner.h>
+#include <gamekid/utils/bytes.h>
+#include <gamekid/utils/files.h>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <sstream>
+
+using gamekid::batch::batch_runner;
+using gamekid::batch::batch_job;
+
+namespace {
+    // a file which is read once for all the jobs, or the reason it couldn't be
+    template <typename T>
+    struct shared_file {
+        std::shared_ptr<const T> value;
+        std::string error;
+    };
+
+    template <typename T, typename Read>
+    shared_file<T> read_shared(const std::string& file_name, Read read) {
+        try {
+            return { std::make_shared<const T>(read(file_name)), "" };
+        } catch (const std::exception& e) {
+            return { nullptr, file_name + ": " + e.what() };
+        }
+    }
+}
+
+batch_runner::batch_runner(const batch_options& options) :
+_options(options), _pool(options.threads), _scratch(_pool.size()) {
+}
+
+void batch_runner::run(const std::vector<batch_job>& jobs, const output& output) {
+    std::map<std::string, shared_file<rom::cartridge>> roms;
+    std::map<std::string, shared_file<input_movie>> movies;
+
+    for (const batch_job& job : jobs) {
+        if (roms.find(job.rom) == roms.end()) {
+            roms[job.rom] = read_shared<rom::cartridge>(job.rom,
+                [](const std::string& name) { return rom::cartridge(utils::files::read_file(name)); });
+        }
+
+        if (!job.movie.empty() && movies.find(job.movie) == movies.end()) {
+            movies[job.movie] = read_shared<input_movie>(job.movie, input_movie::load_file);
+        }
+    }
+
+    for (size_t index = 0; index < jobs.size(); ++index) {
+        _pool.submit([this, index, &jobs, &roms, &movies, &output](size_t worker) {
+            const batch_job& job = jobs[index];
+            const auto start = std::chrono::steady_clock::now();
+            batch_result result{};
+            result.job = index;
+            result.worker = worker;
+
+            try {
+                const shared_file<rom::cartridge>& rom = roms.at(job.rom);
+                const input_movie* movie = nullptr;
+
+                if (rom.value == nullptr) {
+                    throw std::exception(rom.error.c_str());
+                }
+
+                if (!job.movie.empty()) {
+                    const shared_file<input_movie>& file = movies.at(job.movie);
+
+                    if (file.value == nullptr) {
+                        throw std::exception(file.error.c_str());
+                    }
+
+                    movie = file.value.get();
+                }
+
+                // the runners are large, they are not kept on the worker's stack
+                auto instance = std::make_unique<runner>(rom::cartridge(*rom.value));
+
+                if (_options.skip_boot_rom) {
+                    instance->skip_boot_rom();
+                }
+
+                size_t next_event = 0;
+
+                for (; result.frames < job.frames; ++result.frames) {
+                    if (movie != nullptr) {
+                        next_event = movie->post(instance->joypad(), next_event, instance->lcd().frame_count());
+                    }
+
+                    instance->run_frame();
+                    // nothing plays the samples, they would grow for as long as the job runs
+                    instance->apu().clear_samples();
+                }
+
+                const io::video::frame& screen = instance->lcd().screen();
+                result.screen = utils::bytes::hash(screen.data(), screen.size());
+
+                state::snapshot& image = _scratch[worker].image;
+                instance->save(image);
+                result.state = utils::bytes::hash(image.data(), image.size());
+            } catch (const std::exception& e) {
+                result.error = e.what();
+            }
+
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            result.milliseconds = elapsed.count();
+
+            std::lock_guard<std::mutex> guard(_output_lock);
+            output(result);
+        });
+    }
+
+    _pool.wait();
+}
+
+std::vector<batch_job> batch_runner::instances(const batch_job& job, size_t count) {
+    return std::vector<batch_job>(count, job);
+}
+
+std::vector<batch_job> batch_runner::parse_jobs(const std::string& text) {
+    std::vector<batch_job> jobs;
+    std::istringstream lines(text);
+    std::string line;
+
+    while (std::getline(lines, line)) {
+        const size_t first = line.find_first_not_of(" \t\r");
+
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        batch_job job{};
+
+        if (!(fields >> job.frames >> job.rom)) {
+            throw std::exception("Bad job line");
+        }
+
+        fields >> job.movie;
+        jobs.push_back(job);
+    }
+
+    return jobs;
+}
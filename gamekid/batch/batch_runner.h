@@ -0,0 +1,73 @@
+#pragma once
+#include "work_stealing_pool.h"
+#include <gamekid/state/snapshot.h>
+#include <gamekid/utils/types.h>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gamekid::batch {
+    struct batch_job {
+        std::string rom;
+        // an input_movie file (in lcd frames since the runner started), none when empty
+        std::string movie;
+        dword frames;
+    };
+
+    struct batch_result {
+        // the index of the job, and of the worker that ran it
+        size_t job;
+        size_t worker;
+        // fewer than the job's when it failed
+        dword frames;
+        // empty when the job ran all its frames
+        std::string error;
+        double milliseconds;
+        // of the last screen, and of the state the job ended in, to compare runs
+        std::uint64_t screen;
+        std::uint64_t state;
+    };
+
+    struct batch_options {
+        // a thread for every core when 0
+        size_t threads = 0;
+        // the jobs start at the cartridge's entry point, with the state the boot rom leaves
+        bool skip_boot_rom = true;
+    };
+
+    // Runs many headless runners in one process, on a work stealing pool.
+    // A job's runner is created, run and destroyed by one worker, so it is only touched by one thread.
+    // The roms and the movies are read once, the copies of a rom share it.
+    // Results are given to the output as the jobs end, one at a time
+    class batch_runner {
+    public:
+        using output = std::function<void(const batch_result& result)>;
+    private:
+        // reused by the jobs of a worker
+        struct worker_scratch {
+            state::snapshot image;
+        };
+
+        batch_options _options;
+        work_stealing_pool _pool;
+        std::vector<worker_scratch> _scratch;
+        std::mutex _output_lock;
+    public:
+        explicit batch_runner(const batch_options& options = {});
+
+        size_t threads() const {
+            return _pool.size();
+        }
+
+        // Returns when every job ended, the errors of a job are in its result
+        void run(const std::vector<batch_job>& jobs, const output& output);
+
+        // The same job for many instances
+        static std::vector<batch_job> instances(const batch_job& job, size_t count);
+
+        // Lines of <frames> <rom> [<movie>], the paths without spaces. Empty lines and lines which start with # are skipped
+        static std::vector<batch_job> parse_jobs(const std::string& text);
+    };
+}
@@ -0,0 +1,62 @@
+#include "input_movie.h"
+#include <gamekid/utils/files.h>
+#include <algorithm>
+#include <sstream>
+
+using gamekid::batch::input_movie;
+using gamekid::io::joypad_button;
+
+namespace {
+    const char* const button_names[] = { "a", "b", "select", "start", "right", "left", "up", "down" };
+}
+
+input_movie input_movie::parse(const std::string& text) {
+    input_movie movie;
+    std::istringstream lines(text);
+    std::string line;
+
+    while (std::getline(lines, line)) {
+        const size_t first = line.find_first_not_of(" \t\r");
+
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::uint64_t frame;
+        std::string button, state;
+
+        if (!(fields >> frame >> button >> state) || (state != "down" && state != "up")) {
+            throw std::exception("Bad input movie line");
+        }
+
+        const auto name = std::find(std::begin(button_names), std::end(button_names), button);
+
+        if (name == std::end(button_names)) {
+            throw std::exception("Unknown input movie button");
+        }
+
+        const auto value = static_cast<joypad_button>(name - std::begin(button_names));
+        movie._events.push_back({ frame, io::input_time::frame, value, state == "down" });
+    }
+
+    // the changes of the same frame stay in the order they were written
+    std::stable_sort(movie._events.begin(), movie._events.end(),
+        [](const io::joypad_event& left, const io::joypad_event& right) { return left.time < right.time; });
+    return movie;
+}
+
+input_movie input_movie::load_file(const std::string& file_name) {
+    const std::vector<byte> data = utils::files::read_file(file_name);
+    return parse(std::string(data.begin(), data.end()));
+}
+
+size_t input_movie::post(io::joypad_input& joypad, size_t next, dword frame) const {
+    for (; next < _events.size() && _events[next].time <= frame; ++next) {
+        if (!joypad.post(_events[next])) {
+            throw std::exception("Too many input changes in a frame");
+        }
+    }
+
+    return next;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <gamekid/io/joypad_input.h>
+#include <string>
+#include <vector>
+
+namespace gamekid::batch {
+
+    // The input of a run, as text with a line for every change of a button:
+    //     <frame> <button> <down|up>
+    // The buttons are a, b, select, start, right, left, up and down. The change is applied at the start of the frame.
+    // Empty lines and lines which start with # are skipped
+    class input_movie {
+    private:
+        // in the order of their frames
+        std::vector<io::joypad_event> _events;
+    public:
+        // Throws on a line which is not an event
+        static input_movie parse(const std::string& text);
+        static input_movie load_file(const std::string& file_name);
+
+        const std::vector<io::joypad_event>& events() const {
+            return _events;
+        }
+
+        // Posts the events up to the frame, starting at the given event.
+        // Returns the event to start at for the next frame
+        size_t post(io::joypad_input& joypad, size_t next, dword frame) const;
+    };
+}
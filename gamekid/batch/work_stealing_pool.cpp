@@ -0,0 +1,131 @@
+#include "work_stealing_pool.h"
+#include <algorithm>
+
+using gamekid::batch::work_stealing_pool;
+
+work_stealing_pool::work_stealing_pool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t worker = 0; worker < threads; ++worker) {
+        _queues.push_back(std::make_unique<worker_queue>());
+    }
+
+    for (size_t worker = 0; worker < threads; ++worker) {
+        _threads.emplace_back([this, worker]() { work(worker); });
+    }
+}
+
+work_stealing_pool::~work_stealing_pool() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stopping = true;
+    }
+
+    _wake.notify_all();
+
+    for (std::thread& thread : _threads) {
+        thread.join();
+    }
+}
+
+void work_stealing_pool::submit(task task) {
+    size_t worker;
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        worker = _next_queue;
+        _next_queue = (_next_queue + 1) % _queues.size();
+    }
+
+    submit(worker, std::move(task));
+}
+
+void work_stealing_pool::submit(size_t worker, task task) {
+    // counted before it is queued, a worker which sees the count and not the task yet tries again
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        ++_queued;
+        ++_unfinished;
+    }
+
+    {
+        worker_queue& queue = *_queues[worker % _queues.size()];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    _wake.notify_one();
+}
+
+void work_stealing_pool::wait() {
+    std::unique_lock<std::mutex> guard(_lock);
+    _done.wait(guard, [this]() { return _unfinished == 0; });
+}
+
+bool work_stealing_pool::pop(size_t worker, task& result) {
+    {
+        worker_queue& own = *_queues[worker];
+        std::lock_guard<std::mutex> guard(own.lock);
+
+        if (!own.tasks.empty()) {
+            result = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // the other queues, starting from the next one so the workers don't all steal from the same queue
+    for (size_t offset = 1; offset < _queues.size(); ++offset) {
+        worker_queue& other = *_queues[(worker + offset) % _queues.size()];
+        std::lock_guard<std::mutex> guard(other.lock);
+
+        if (!other.tasks.empty()) {
+            result = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void work_stealing_pool::work(size_t worker) {
+    task current;
+
+    while (true) {
+        if (pop(worker, current)) {
+            {
+                std::lock_guard<std::mutex> guard(_lock);
+                --_queued;
+            }
+
+            current(worker);
+            current = nullptr;
+
+            std::lock_guard<std::mutex> guard(_lock);
+
+            if (--_unfinished == 0) {
+                _done.notify_all();
+            }
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(_lock);
+
+        if (_queued > 0) {
+            // a task was counted and is about to be queued, or was taken by another worker
+            guard.unlock();
+            std::this_thread::yield();
+            continue;
+        }
+
+        if (_stopping) {
+            return;
+        }
+
+        _wake.wait(guard, [this]() { return _queued > 0 || _stopping; });
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gamekid::batch {
+
+    // Threads which run tasks from their own queue, newest first, and take the oldest task of another
+    // queue when theirs is empty. A task runs on one worker from its start to its end, and is given
+    // the index of the worker so it can use the worker's buffers.
+    // The tasks are long (a run of many frames), the queues are not lock free
+    class work_stealing_pool {
+    public:
+        // Doesn't throw, the pool has no way to report an error
+        using task = std::function<void(size_t worker)>;
+    private:
+        struct worker_queue {
+            std::mutex lock;
+            std::deque<task> tasks;
+        };
+
+        std::vector<std::unique_ptr<worker_queue>> _queues;
+        std::vector<std::thread> _threads;
+
+        std::mutex _lock;
+        std::condition_variable _wake;
+        std::condition_variable _done;
+        // the tasks in the queues, and the ones that were submitted and didn't end yet
+        size_t _queued = 0;
+        size_t _unfinished = 0;
+        size_t _next_queue = 0;
+        bool _stopping = false;
+
+        bool pop(size_t worker, task& result);
+        void work(size_t worker);
+    public:
+        // A thread for every core when threads is 0
+        explicit work_stealing_pool(size_t threads = 0);
+        // Runs the tasks which are queued and joins the threads
+        ~work_stealing_pool();
+
+        work_stealing_pool(const work_stealing_pool&) = delete;
+        work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+        size_t size() const {
+            return _threads.size();
+        }
+
+        // Queues the task on the next worker's queue, in turn
+        void submit(task task);
+        void submit(size_t worker, task task);
+
+        // Blocks until every task that was submitted ended
+        void wait();
+    };
+}
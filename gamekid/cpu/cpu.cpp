@@ -1,5 +1,7 @@
 #include "cpu.h"
 #include "operands_container.h"
+#include <gamekid/state/snapshot.h>
+#include <array>
 
 using namespace gamekid::cpu;
 
@@ -38,12 +40,25 @@ cpu::cpu(gamekid::system& system) :
     regs.emplace_back(&HL);
     regs.emplace_back(&SP);
     regs.emplace_back(&PC);
+
+    _slots = { &A, &B, &C, &D, &E, &F, &H, &L, &AF, &BC, &DE, &HL, &SP, &PC };
+    _operands->add_slots(_slots);
 }
 
 operands_container& cpu::operands(){
     return *_operands;
 }
 
+size_t cpu::slot(const operand_base& operand) const {
+    for (size_t index = 0; index < _slots.size(); ++index) {
+        if (_slots[index] == &operand) {
+            return index;
+        }
+    }
+
+    throw std::exception("Operand is not a part of the cpu");
+}
+
 void cpu::enable_interrupts(){
     _interrupts_enabled = true;
 }
@@ -60,4 +75,21 @@ gamekid::system& cpu::system() {
     return _system;
 }
 
+void cpu::save(state::snapshot& snapshot) const {
+    snapshot.write(A.load(), B.load(), C.load(), D.load(), E.load(), F.load(), H.load(), L.load());
+    snapshot.write(_sp_value_low, _sp_value_high, _pc_value_low, _pc_value_high, _interrupts_enabled);
+}
+
+void cpu::load(state::snapshot& snapshot) {
+    std::array<byte, 8> registers;
+    snapshot.read(registers);
+    snapshot.read(_sp_value_low, _sp_value_high, _pc_value_low, _pc_value_high, _interrupts_enabled);
+
+    operands::reg8* const file[] = { &A, &B, &C, &D, &E, &F, &H, &L };
+
+    for (size_t i = 0; i < registers.size(); ++i) {
+        file[i]->store(registers[i]);
+    }
+}
+
 cpu::~cpu() = default;
\ No newline at end of file
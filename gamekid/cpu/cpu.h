@@ -14,6 +14,8 @@ namespace gamekid::cpu{ class operands_container;}
 
 namespace gamekid { class system; }
 
+namespace gamekid::state { class snapshot; }
+
 namespace gamekid::cpu {
     class cpu {
     private:
@@ -23,6 +25,8 @@ namespace gamekid::cpu {
         byte _pc_value_low;
         byte _pc_value_high;
         std::unique_ptr<operands_container> _operands;
+        // the registers and then the operands of the container, in the same order in every cpu
+        std::vector<operand_base*> _slots;
     public:
         explicit cpu(system& system);
         
@@ -45,6 +49,14 @@ namespace gamekid::cpu {
         std::vector<reg*> regs;
 
         operands_container& operands();
+
+        // The slot of an operand of this cpu, so an opcode built with this cpu can run on any cpu
+        size_t slot(const operand_base& operand) const;
+
+        template <typename T>
+        operand<T>& slot(size_t index) {
+            return static_cast<operand<T>&>(*_slots[index]);
+        }
         void enable_interrupts();
         void disable_interrupts();
 
@@ -56,6 +68,10 @@ namespace gamekid::cpu {
         memory::memory& memory();
         system& system();
 
+        // The register file
+        void save(state::snapshot& snapshot) const;
+        void load(state::snapshot& snapshot);
+
         template <typename T>
         T immidiate() {
             const word imm_ptr = PC.load() - sizeof(T);
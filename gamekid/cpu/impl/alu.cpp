@@ -159,6 +159,18 @@ void alu::initialize() {
         .operands(_cpu.SP, _cpu.operands().immidiate_byte()).opcode(ADD_SP_IMM).cycles(16).operation(add_to_sp_operation).add()
         .build()
     );
+    add_alu_instruction("adc", opcodes_struct {
+                            ADC_A,
+                            ADC_B,
+                            ADC_C,
+                            ADC_D,
+                            ADC_E,
+                            ADC_H,
+                            ADC_L,
+                            ADC_HL_mem,
+                            ADC_IMM,
+        }, adc_operation);
+
     add_alu_instruction("sub", opcodes_struct {
                             SUB_A,
                             SUB_B,
@@ -258,10 +270,10 @@ void alu::initialize() {
         .operands(_cpu.E).opcode(DEC_E).cycles(4).operation(dec_operation).add()
         .operands(_cpu.H).opcode(DEC_H).cycles(4).operation(dec_operation).add()
         .operands(_cpu.L).opcode(DEC_L).cycles(4).operation(dec_operation).add()
-        .operands(_cpu.BC).opcode(DEC_BC).cycles(4).operation(dec_word_operation).add()
-        .operands(_cpu.DE).opcode(DEC_DE).cycles(4).operation(dec_word_operation).add()
-        .operands(_cpu.HL).opcode(DEC_HL).cycles(4).operation(dec_word_operation).add()
-        .operands(_cpu.SP).opcode(DEC_SP).cycles(4).operation(dec_word_operation).add()
+        .operands(_cpu.BC).opcode(DEC_BC).cycles(8).operation(dec_word_operation).add()
+        .operands(_cpu.DE).opcode(DEC_DE).cycles(8).operation(dec_word_operation).add()
+        .operands(_cpu.HL).opcode(DEC_HL).cycles(8).operation(dec_word_operation).add()
+        .operands(_cpu.SP).opcode(DEC_SP).cycles(8).operation(dec_word_operation).add()
         .operands(_cpu.operands().reg_mem(_cpu.HL)).opcode(DEC_HL_mem).cycles(12).operation(dec_operation).add()
         .build()
     );
@@ -41,7 +41,7 @@ void bitmask::build_register_opcodes(builders::instruction_builder& builder,
 }
 
 void bitmask::add_bitmask_instruction(const std::string& name, const opcodes_struct& opcodes,
-    cpu_operation<byte, byte> operation){
+    cpu_operation<byte, byte> operation, byte hl_mem_cycles){
     builders::instruction_builder builder(_cpu, name);
     build_register_opcodes(builder, opcodes.A, _cpu.A, operation);
     build_register_opcodes(builder, opcodes.B, _cpu.B, operation);
@@ -50,7 +50,7 @@ void bitmask::add_bitmask_instruction(const std::string& name, const opcodes_str
     build_register_opcodes(builder, opcodes.E, _cpu.E, operation);
     build_register_opcodes(builder, opcodes.H, _cpu.H, operation);
     build_register_opcodes(builder, opcodes.L, _cpu.L, operation);
-    build_register_opcodes(builder, opcodes.HL_mem, _cpu.operands().reg_mem(_cpu.HL), operation, 16);
+    build_register_opcodes(builder, opcodes.HL_mem, _cpu.operands().reg_mem(_cpu.HL), operation, hl_mem_cycles);
     _set.add_instruction(builder.build());
 }
 
@@ -64,7 +64,7 @@ void bitmask::initialize(){
         BIT_H,
         BIT_L,
         BIT_HL_mem
-    }, bit_operation);
+    }, bit_operation, 12);
 
     add_bitmask_instruction("res", opcodes_struct {
         RES_A,
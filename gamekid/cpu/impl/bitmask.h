@@ -21,7 +21,8 @@ namespace gamekid::cpu::impl {
         void add_bitmask_instruction(
             const std::string& name,
             const opcodes_struct& opcodes,
-            cpu_operation<byte, byte> operation
+            cpu_operation<byte, byte> operation,
+            byte hl_mem_cycles = 16
         );
     public:
         bitmask(cpu& cpu, instruction_set& set) : _cpu(cpu), _set(set) {}
@@ -65,7 +65,7 @@ void jumps::initialize(cpu & cpu, instruction_set & set){
     set.add_instruction(builders::instruction_builder(cpu, "jp")
         .operands(cpu.operands().immidiate_word())
             .opcode(0xC3)
-            .cycles(12)
+            .cycles(16)
             .operation(jp_operation)
             .add()
         .operands(cpu.operands().nz(), cpu.operands().immidiate_word())
@@ -98,7 +98,7 @@ void jumps::initialize(cpu & cpu, instruction_set & set){
     set.add_instruction(builders::instruction_builder(cpu, "jr")
         .operands(cpu.operands().immidiate_byte())
             .opcode(0x18)
-            .cycles(8)
+            .cycles(12)
             .operation(jr_operation)
             .add()
         .operands(cpu.operands().nz(), cpu.operands().immidiate_byte())
@@ -127,7 +127,7 @@ void jumps::initialize(cpu & cpu, instruction_set & set){
     set.add_instruction(builders::instruction_builder(cpu, "call")
         .operands(cpu.operands().immidiate_word())
             .opcode(0xCD)
-            .cycles(12)
+            .cycles(24)
             .operation(call_operation)
             .add()
         .operands(cpu.operands().nz(), cpu.operands().immidiate_word())
@@ -158,7 +158,7 @@ void jumps::initialize(cpu & cpu, instruction_set & set){
         rst_builder
             .operands(cpu.operands().constant(i))
             .opcode(0xC7 + i)
-            .cycles(32)
+            .cycles(16)
             .operation(rst_operation)
             .add();
     }
@@ -168,7 +168,7 @@ void jumps::initialize(cpu & cpu, instruction_set & set){
     set.add_instruction(builders::instruction_builder(cpu, "ret")
         .operands()
             .opcode(0xC9)
-            .cycles(0x8)
+            .cycles(16)
             .operation(ret_operation)
             .add()
         .operands(cpu.operands().nz())
@@ -196,7 +196,7 @@ void jumps::initialize(cpu & cpu, instruction_set & set){
     set.add_instruction(builders::instruction_builder(cpu, "reti")
         .operands()
             .opcode(0xD9)
-            .cycles(8)
+            .cycles(16)
             .operation(reti_operation)
             .add()
         .build());
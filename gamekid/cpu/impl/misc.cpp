@@ -60,15 +60,11 @@ void misc::ccf_operation(cpu& cpu){
 }
 
 void misc::ei_operation(cpu& cpu){
-    cpu.system().schedule_operation([](gamekid::system& sys){
-        sys.cpu().enable_interrupts();
-    }, 1);
+    cpu.system().schedule_operation(gamekid::scheduled_action::enable_interrupts, 1);
 }
 
 void misc::di_operation(cpu& cpu){
-    cpu.system().schedule_operation([](gamekid::system& sys){
-        sys.cpu().disable_interrupts();
-    }, 1);
+    cpu.system().schedule_operation(gamekid::scheduled_action::disable_interrupts, 1);
 }
 
 void misc::halt_operation(cpu& cpu) {
@@ -84,7 +80,7 @@ void misc::initialize(cpu& cpu, instruction_set& set){
         .operands(cpu.E).opcode(SWAP_E).operation(swap_operation).cycles(8).add()
         .operands(cpu.H).opcode(SWAP_H).operation(swap_operation).cycles(8).add()
         .operands(cpu.L).opcode(SWAP_L).operation(swap_operation).cycles(8).add()
-        .operands(cpu.operands().reg_mem(cpu.HL)).opcode(SWAP_HL_mem).operation(swap_operation).cycles(8).add()
+        .operands(cpu.operands().reg_mem(cpu.HL)).opcode(SWAP_HL_mem).operation(swap_operation).cycles(16).add()
         .build());
 
     set.add_instruction(builders::instruction_builder(cpu, "cpl")
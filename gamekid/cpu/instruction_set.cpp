@@ -5,6 +5,7 @@
 #include "impl/misc.h"
 #include "impl/mem.h"
 #include "impl/jumps.h"
+#include <gamekid/system.h>
 
 using namespace gamekid::cpu;
 
@@ -23,11 +24,36 @@ instruction_set::instruction_set(cpu& cpu) : _cpu(cpu){
     impl::jumps::initialize(cpu, *this);
 }
 
+instruction_set& instruction_set::shared() {
+    struct shared_set {
+        system system;
+        instruction_set set{ system.cpu() };
+    };
+
+    static shared_set instance;
+    return instance.set;
+}
+
 void instruction_set::add_instruction(std::unique_ptr<instruction> ins) {
     _ptr_instructions.push_back(ins.get());
     _instructions.push_back(std::move(ins));
 }
 
+size_t instruction_set::heap_size() const {
+    size_t size = (_instructions.capacity() + _ptr_instructions.capacity()) * sizeof(instruction*);
+
+    for (const instruction* ins : _ptr_instructions) {
+        size += sizeof(instruction) + ins->name.capacity();
+
+        for (const opcode* op : *ins) {
+            // the opcode and its pointers in the instruction
+            size += sizeof(opcode) + op->name.capacity() + op->value.capacity() + 2 * sizeof(opcode*);
+        }
+    }
+
+    return size;
+}
+
 const std::vector<instruction*>& instruction_set::instructions() {
     return _ptr_instructions;
 }
@@ -11,9 +11,16 @@ namespace gamekid::cpu {
     public:
         cpu & _cpu;
         const std::vector<instruction*>& instructions();
+        // The opcodes are built with the operands of the cpu, and can run on any cpu
         explicit instruction_set(cpu& cpu);
         void add_instruction(std::unique_ptr<instruction> instruction);
 
+        // The instruction set of the process, built once (with a cpu of its own) and shared by every runner
+        static instruction_set& shared();
+
+        // The memory of the instructions and their opcodes, in bytes. Estimated, the opcodes are of many types
+        size_t heap_size() const;
+
         std::vector<instruction*>::iterator begin() { return _ptr_instructions.begin(); }
         std::vector<instruction*>::iterator end() { return _ptr_instructions.end(); }
 
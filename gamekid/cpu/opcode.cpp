@@ -3,8 +3,8 @@
 
 using namespace gamekid::cpu;
 
-opcode::opcode(cpu & cpu, const std::string & name, std::vector<byte> value, byte cycles)
-    : _cpu(cpu), name(name), value(std::move(value)), cycles(cycles) {
+opcode::opcode(const std::string & name, std::vector<byte> value, byte cycles)
+    : name(name), value(std::move(value)), cycles(cycles) {
     if (name.empty()) {
         throw std::exception("Opcode name is empty");
     }
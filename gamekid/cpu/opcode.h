@@ -7,17 +7,16 @@
 #include <vector>
 
 namespace gamekid::cpu {
+    // An opcode is immutable and is shared by every cpu, it runs on the cpu it is given
     class opcode {
-    protected:
-        cpu & _cpu;
     public:
         const std::string name;
         const std::vector<byte> value;
         const byte cycles;
 
-        opcode(cpu& cpu, const std::string& name, std::vector<byte> value, byte cycles);
+        opcode(const std::string& name, std::vector<byte> value, byte cycles);
 
-        virtual void run() = 0;
+        virtual void run(cpu& cpu) const = 0;
         virtual ~opcode() = default;
 
         virtual std::vector<byte> encode(const std::vector<std::string>& operands) const;
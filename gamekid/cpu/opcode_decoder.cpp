@@ -14,23 +14,27 @@ void opcode_decoder::initialize_tables(){
     for (instruction* instruction : _set.instructions()){
         for (opcode* op : *instruction) {
             const word opcode_word_value = gamekid::utils::bytes::little_endian_decode<word>(op->value);
-            _opcode_table.insert(std::pair<word, opcode*>(opcode_word_value, op));
-        }
-    }
-}
+            opcode*& entry = _opcode_table[opcode_table::index(opcode_word_value)];
 
-opcode* opcode_decoder::decode(word opcode_word) {
-    auto two_bytes_opcode = _opcode_table.find(opcode_word);
+            if (entry != nullptr) {
+                throw std::exception("Two opcodes have the same value");
+            }
 
-    if (two_bytes_opcode != _opcode_table.end()) {
-        return two_bytes_opcode->second;
+            entry = op;
+        }
     }
+}
 
-    auto one_byte_opcode = _opcode_table.find(opcode_word & 0xFF);
+const opcode_decoder& opcode_decoder::shared() {
+    static const opcode_decoder instance(instruction_set::shared());
+    return instance;
+}
 
-    if (one_byte_opcode != _opcode_table.end()) {
-        return one_byte_opcode->second;
-    }
+const opcode* opcode_decoder::decode(word opcode_word) const {
+    // the byte after a one byte opcode doesn't change the entry
+    return _opcode_table[opcode_table::index(opcode_word)];
+}
 
-    return nullptr;
-}
\ No newline at end of file
+size_t opcode_decoder::heap_size() const {
+    return sizeof(_opcode_table);
+}
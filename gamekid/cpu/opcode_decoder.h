@@ -1,16 +1,24 @@
 #pragma once
 #include <gamekid/cpu/instruction_set.h>
-#include <map>
+#include <gamekid/cpu/opcode_table.h>
+#include <array>
 
 namespace gamekid::cpu {
     class opcode_decoder {
     private:
-        std::map<word, opcode*> _opcode_table;
+        // an opcode in the entry of the opcode table, null for the opcodes which are not in the set
+        std::array<opcode*, opcode_table::size> _opcode_table{};
         instruction_set & _set;
         void initialize_tables();
     public:
         explicit opcode_decoder(instruction_set& set);
-        opcode* decode(word opcode_bytes);
+        const opcode* decode(word opcode_bytes) const;
+
+        // The decoder of the shared instruction set
+        static const opcode_decoder& shared();
+
+        // The memory of the table, in bytes
+        size_t heap_size() const;
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,171 @@
+#pragma once
+#include <gamekid/utils/types.h>
+#include <array>
+
+// The reference size and cycles of every opcode, written by hand from the cpu's documentation.
+// The first 256 entries are the one byte opcodes, the next 256 are the ones after the 0xCB prefix.
+// The instruction set is built at run time from the instruction builders, not from this table:
+// OPCODES_MATCH_THE_OPCODE_TABLE checks that the builders agree with it. The static_asserts below
+// only check the table itself (its layout, and the data for typos)
+namespace gamekid::cpu::opcode_table {
+    enum class kind : byte {
+        // no instruction, the cpu locks up
+        illegal,
+        // the 0xCB byte, which starts the two bytes opcodes
+        prefix,
+        instruction
+    };
+
+    struct entry {
+        kind type;
+        // with the immidiate bytes
+        byte size;
+        // of a conditional jump, call or return which is not taken
+        byte cycles;
+    };
+
+    const size_t size = 512;
+    const byte cb_prefix = 0xCB;
+
+    // The entry of the opcode which starts with the bytes (in little endian)
+    constexpr size_t index(word opcode_word) {
+        const byte first = opcode_word & 0xFF;
+        return first == cb_prefix ? 0x100 + (opcode_word >> 8) : first;
+    }
+
+    namespace details {
+        // 0 is an illegal opcode. 0x40-0xBF are the loads and the alu operations, which follow a pattern
+        constexpr byte sizes[8][16] = {
+            { 1, 3, 1, 1, 1, 1, 2, 1, 3, 1, 1, 1, 1, 1, 2, 1 },
+            { 2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1 },
+            { 2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1 },
+            { 2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1 },
+            { 1, 1, 3, 3, 3, 1, 2, 1, 1, 1, 3, 2, 3, 3, 2, 1 },
+            { 1, 1, 3, 0, 3, 1, 2, 1, 1, 1, 3, 0, 3, 0, 2, 1 },
+            { 2, 1, 1, 0, 0, 1, 2, 1, 2, 1, 3, 0, 0, 0, 2, 1 },
+            { 2, 1, 1, 1, 0, 1, 2, 1, 2, 1, 3, 1, 0, 0, 2, 1 },
+        };
+
+        constexpr byte cycles[8][16] = {
+            {  4, 12,  8,  8,  4,  4,  8,  4, 20,  8,  8,  8,  4,  4,  8,  4 },
+            {  4, 12,  8,  8,  4,  4,  8,  4, 12,  8,  8,  8,  4,  4,  8,  4 },
+            {  8, 12,  8,  8,  4,  4,  8,  4,  8,  8,  8,  8,  4,  4,  8,  4 },
+            {  8, 12,  8,  8, 12, 12, 12,  4,  8,  8,  8,  8,  4,  4,  8,  4 },
+            {  8, 12, 12, 16, 12, 16,  8, 16,  8, 16, 12,  4, 12, 24,  8, 16 },
+            {  8, 12, 12,  0, 12, 16,  8, 16,  8, 16, 12,  0, 12,  0,  8, 16 },
+            { 12, 12,  8,  0,  0, 16,  8, 16, 16,  4, 16,  0,  0,  0,  8, 16 },
+            { 12, 12,  8,  4,  0, 16,  8, 16, 12,  8, 16,  4,  0,  0,  8, 16 },
+        };
+
+        // [HL] is the 6th operand of the loads, the alu operations and the prefixed opcodes
+        constexpr bool hl_mem_operand(byte value) {
+            return (value & 0x07) == 0x06;
+        }
+
+        constexpr entry primary(byte value) {
+            if (value >= 0x40 && value < 0xC0) {
+                const bool loads_to_hl_mem = value >= 0x70 && value < 0x78;
+                // halt is in the place of ld [HL], [HL]
+                const bool memory = value != 0x76 && (hl_mem_operand(value) || loads_to_hl_mem);
+                return { kind::instruction, 1, static_cast<byte>(memory ? 8 : 4) };
+            }
+
+            const size_t row = value < 0x40 ? value >> 4 : (value >> 4) - 8;
+            const byte length = sizes[row][value & 0x0F];
+
+            if (value == cb_prefix) {
+                return { kind::prefix, 1, cycles[row][value & 0x0F] };
+            }
+
+            return { length == 0 ? kind::illegal : kind::instruction, length, cycles[row][value & 0x0F] };
+        }
+
+        constexpr entry prefixed(byte value) {
+            if (!hl_mem_operand(value)) {
+                return { kind::instruction, 2, 8 };
+            }
+
+            // bit only reads the memory
+            const bool bit = value >= 0x40 && value < 0x80;
+            return { kind::instruction, 2, static_cast<byte>(bit ? 12 : 16) };
+        }
+
+        constexpr std::array<entry, size> make_entries() {
+            std::array<entry, size> result{};
+
+            for (size_t value = 0; value < 0x100; ++value) {
+                result[value] = primary(static_cast<byte>(value));
+                result[0x100 + value] = prefixed(static_cast<byte>(value));
+            }
+
+            return result;
+        }
+
+        constexpr size_t count(const std::array<entry, size>& table, kind type) {
+            size_t result = 0;
+
+            for (const entry& current : table) {
+                result += current.type == type ? 1 : 0;
+            }
+
+            return result;
+        }
+
+        // Every opcode word is decoded to the entry of its opcode, and the entries of different opcodes differ
+        constexpr bool indices_are_unique() {
+            for (size_t value = 0; value < 0x100; ++value) {
+                if (value != cb_prefix && index(static_cast<word>(value)) != value) {
+                    return false;
+                }
+
+                // what follows a one byte opcode doesn't change it
+                if (value != cb_prefix && index(static_cast<word>(0xAB00 | value)) != value) {
+                    return false;
+                }
+
+                if (index(static_cast<word>(value << 8 | cb_prefix)) != 0x100 + value) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        constexpr bool sizes_are_valid(const std::array<entry, size>& table) {
+            for (size_t value = 0; value < size; ++value) {
+                const entry& current = table[value];
+
+                switch (current.type) {
+                case kind::illegal:
+                    if (current.size != 0 || current.cycles != 0) return false;
+                    break;
+                case kind::prefix:
+                    if (value != cb_prefix) return false;
+                    break;
+                case kind::instruction:
+                    if (current.size < 1 || current.size > 3 || current.cycles == 0 || current.cycles % 4 != 0) return false;
+                    break;
+                }
+            }
+
+            return true;
+        }
+    }
+
+    inline constexpr std::array<entry, size> entries = details::make_entries();
+
+    constexpr const entry& at(word opcode_word) {
+        return entries[index(opcode_word)];
+    }
+
+    // the checks of the table, not of the instruction set
+    static_assert(details::indices_are_unique(), "Two opcodes share an entry");
+    static_assert(details::sizes_are_valid(entries), "An entry has an impossible size or cycles");
+    static_assert(details::count(entries, kind::illegal) == 11, "The cpu has 11 illegal opcodes");
+    static_assert(details::count(entries, kind::prefix) == 1, "Only 0xCB is a prefix");
+    static_assert(details::count(entries, kind::instruction) == size - 12, "Every other opcode is an instruction");
+
+    // a few well known ones, against typos in the rows
+    static_assert(at(0x00).cycles == 4 && at(0x10).size == 2 && at(0xC3).cycles == 16 && at(0xCD).cycles == 24);
+    static_assert(at(0x36).cycles == 12 && at(0x76).cycles == 4 && at(0x46CB).cycles == 12 && at(0x86CB).cycles == 16);
+}
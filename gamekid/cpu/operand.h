@@ -4,11 +4,15 @@
 #include <gamekid/utils/types.h>
 
 namespace gamekid::cpu {
-    template <typename T>
-    class operand {
+    // The operands of every type, a cpu keeps its operands in slots of this type
+    class operand_base {
     public:
-        virtual ~operand() = default;
+        virtual ~operand_base() = default;
+    };
 
+    template <typename T>
+    class operand : public operand_base {
+    public:
         virtual T load() const = 0;
         virtual void store(T value) = 0;
         virtual std::string to_str(const byte* next) const = 0;
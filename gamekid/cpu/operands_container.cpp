@@ -20,9 +20,35 @@ _z(sys.cpu().F, flags_reg8::ZERO, "z", true),
 _nc(sys.cpu().F, flags_reg8::CARRY, "nc", false),
 _c(sys.cpu().F, flags_reg8::CARRY, "c", true),
 _hl_addressing(sys.cpu().HL){
-    _constants.reserve(20);
-    _reg16_with_offset_operands.reserve(20);
-    _reg_mem_operands.reserve(20);
+    // every operand is created here, the slots of all the cpus must be the same.
+    // the bits of bit, set and res and the vectors of rst
+    _constants.reserve(15);
+
+    for (byte value = 0; value < 8; ++value) {
+        _constants.emplace_back(value);
+    }
+
+    for (byte value = 0x08; value <= 0x38; value += 8) {
+        _constants.emplace_back(value);
+    }
+
+    _reg_mem_operands.reserve(3);
+    _reg_mem_operands.emplace_back(sys.memory(), sys.cpu().BC);
+    _reg_mem_operands.emplace_back(sys.memory(), sys.cpu().DE);
+    _reg_mem_operands.emplace_back(sys.memory(), sys.cpu().HL);
+    _reg16_with_offset_operands.emplace_back(sys, sys.cpu().SP);
+}
+
+void operands_container::add_slots(std::vector<operand_base*>& slots) {
+    for (operand_base* operand : std::initializer_list<operand_base*>{ &_immidiate_byte, &_immidiate_word,
+        &_immidiate_mem_byte, &_immidiate_mem_word, &_c_mem, &_inc_hl, &_dec_hl, &_ff_offset,
+        &_nz, &_z, &_nc, &_c, &_hl_addressing }) {
+        slots.push_back(operand);
+    }
+
+    for (auto& operand : _reg_mem_operands) slots.push_back(&operand);
+    for (auto& operand : _reg16_with_offset_operands) slots.push_back(&operand);
+    for (auto& operand : _constants) slots.push_back(&operand);
 }
 
 c_mem_operand& operands_container::c_memory(){
@@ -43,9 +69,8 @@ constant_operand& operands_container::constant(byte val){
             return op;
         }
     }
-    _constants.emplace_back(val);
-    constant_operand& op =  _constants.back();
-    return op;
+
+    throw std::exception("Constant operand is not in the container");
 }
 
 ff_offset_mem_operand& operands_container::ff_offset(){
@@ -78,7 +103,8 @@ reg_mem_operand& operands_container::reg_mem(reg16& r){
             return offset;
         }
     }
-    return _reg_mem_operands.emplace_back(_system.memory(), r);
+
+    throw std::exception("Memory operand is not in the container");
 }
 
 reg16_with_offset& operands_container::reg16_with_offset(reg16& r){
@@ -88,8 +114,7 @@ reg16_with_offset& operands_container::reg16_with_offset(reg16& r){
         }
     }
 
-    _reg16_with_offset_operands.emplace_back(_system, r);
-    return _reg16_with_offset_operands.back();
+    throw std::exception("Offset operand is not in the container");
 }
 
 imm_operand<byte>& operands_container::immidiate_byte(){
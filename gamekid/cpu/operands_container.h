@@ -38,6 +38,10 @@ namespace gamekid::cpu {
         explicit operands_container(system& system);
         operands_container(const operands_container&) = delete;
         operands_container& operator=(operands_container&) = delete;
+
+        // Adds every operand to the slots of the cpu
+        void add_slots(std::vector<operand_base*>& slots);
+
         operands::reg_mem_operand & reg_mem(operands::reg16& r);
         operands::reg16_with_offset& reg16_with_offset(operands::reg16& r);
         operands::imm_operand<byte>& immidiate_byte();
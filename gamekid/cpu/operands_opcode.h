@@ -1,6 +1,9 @@
 #pragma once
 #include "opcode.h"
+#include <array>
 #include <functional>
+#include <tuple>
+#include <utility>
 #include <gamekid/cpu/cpu_operation.h>
 #include <gamekid/utils/functional.h>
 #include <gamekid/utils/str.h>
@@ -14,13 +17,19 @@ namespace gamekid::cpu {
     {
     private:
         cpu_operation<operand_types...> _operation;
+        // the operands of the cpu the opcode was built with, for the text and the sizes
         operand_tuple<operand_types...> _operands;
+        // the slots of the operands, in which they are found in the cpu that runs
+        std::array<size_t, sizeof...(operand_types)> _slots;
+
+        template <size_t... indices>
+        void run(cpu& cpu, std::index_sequence<indices...>) const;
     public:
         operands_opcode(cpu& cpu, const std::string& name, const std::vector<byte>& value, byte cycles,
             operand_tuple<operand_types...>& operands,
             cpu_operation<operand_types...> operation);
 
-        void run() override;
+        void run(cpu& cpu) const override;
 
         std::vector<byte> encode(const std::vector<std::string>& operands) const override;
 
@@ -34,12 +43,18 @@ namespace gamekid::cpu {
         cpu& cpu, const std::string& name, const std::vector<byte>& value,
         byte cycles, operand_tuple<operand_types...>& operands,
         cpu_operation<operand_types...> operation) :
-        opcode(cpu, name, value, cycles), _operation(operation), _operands(operands){}
+        opcode(name, value, cycles), _operation(operation), _operands(operands),
+        _slots(std::apply([&cpu](auto&... ops) { return std::array<size_t, sizeof...(operand_types)>{ cpu.slot(ops)... }; }, _operands)) {}
+
+    template <typename ... operand_types>
+    template <size_t... indices>
+    void operands_opcode<operand_types...>::run(cpu& cpu, std::index_sequence<indices...>) const {
+        _operation(cpu, cpu.slot<operand_types>(_slots[indices])...);
+    }
 
     template <typename ... operand_types>
-    void operands_opcode<operand_types...>::run() {
-        auto args = std::tuple_cat(std::tuple<cpu&>(_cpu), _operands);
-        gamekid::utils::functional::forward_tuple(_operation, args);
+    void operands_opcode<operand_types...>::run(cpu& cpu) const {
+        run(cpu, std::index_sequence_for<operand_types...>{});
     }
 
     template <typename ... operand_types>
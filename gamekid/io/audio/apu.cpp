@@ -0,0 +1,373 @@
+#include "apu.h"
+#include "audio_timing.h"
+#include "gamekid/io/io_registers.h"
+#include <gamekid/state/snapshot.h>
+#include <algorithm>
+
+using gamekid::io::audio::apu;
+using namespace gamekid::io::audio;
+
+// the bits that read back as 1 (write only and unused bits), from NR10 to 0xFF2F
+const std::array<byte, 0x20> read_masks = {
+    0x80, 0x3F, 0x00, 0xFF, 0xBF,
+    0xFF, 0x3F, 0x00, 0xFF, 0xBF,
+    0x7F, 0xFF, 0x9F, 0xFF, 0xBF,
+    0xFF, 0xFF, 0x00, 0x00, 0xBF,
+    0x00, 0x00, 0x70,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+const word wave_ram = 0xFF30;
+
+const dword oversampling = 4;
+
+apu::apu(synthesis mode) :
+_synthesis(mode), _next_sequencer_cycle(audio_timing::frame_sequencer_cycles),
+_sample_rate(mode == synthesis::oversampled ? audio_timing::sample_rate * oversampling : audio_timing::sample_rate) {
+}
+
+byte apu::load(word address) {
+    if (address >= wave_ram) {
+        return _registers[address - first_register];
+    }
+
+    if (address == NR_52) {
+        // the channel status depends on the length counters
+        flush();
+
+        const byte status = (_square1.enabled() ? 0b0001 : 0) | (_square2.enabled() ? 0b0010 : 0) |
+            (_wave.enabled() ? 0b0100 : 0) | (_noise.enabled() ? 0b1000 : 0);
+
+        return (_registers[NR_52 - first_register] & 0x80) | read_masks[NR_52 - first_register] | status;
+    }
+
+    return _registers[address - first_register] | read_masks[address - first_register];
+}
+
+void apu::store(word address, byte value) {
+    const bool powered = _registers[NR_52 - first_register] & 0x80;
+
+    // only the wave ram and NR52 can be written while the apu is off
+    if (!powered && address < wave_ram && address != NR_52) {
+        return;
+    }
+
+    if (address == NR_52 && !(value & 0x80)) {
+        for (word reg = NR_10; reg < NR_52; ++reg) {
+            _registers[reg - first_register] = 0;
+        }
+    }
+
+    _registers[address - first_register] = address == NR_52 ? (value & 0x80) : value;
+    _writes.push_back({ _cycle, address, value });
+}
+
+void apu::apply(word address, byte value) {
+    if (address >= wave_ram) {
+        _wave.store_wave(static_cast<byte>(address - wave_ram), value);
+    } else if (address == NR_52) {
+        const bool powered = value & 0x80;
+
+        if (_powered && !powered) {
+            // powering off clears every register
+            for (word reg = NR_10; reg < NR_52; ++reg) {
+                apply(reg, 0);
+            }
+        } else if (!_powered && powered) {
+            _sequencer_step = 0;
+        }
+
+        _powered = powered;
+        update_weights();
+    } else if (address == NR_50) {
+        _master_volume = value;
+        update_weights();
+    } else if (address == NR_51) {
+        _panning = value;
+        update_weights();
+    } else if (address >= NR_41 - 1) {
+        _noise.store(static_cast<byte>(address - (NR_41 - 1)), value);
+    } else if (address >= NR_30) {
+        _wave.store(static_cast<byte>(address - NR_30), value);
+    } else if (address >= NR_21 - 1) {
+        _square2.store(static_cast<byte>(address - (NR_21 - 1)), value);
+    } else {
+        _square1.store(static_cast<byte>(address - NR_10), value);
+    }
+}
+
+void apu::update_weights() {
+    const std::array<int, 2> volumes = { ((_master_volume >> 4) & 0b111) + 1, (_master_volume & 0b111) + 1 };
+    const std::array<byte, 2> panning = { static_cast<byte>(_panning >> 4), static_cast<byte>(_panning & 0xF) };
+
+    for (size_t index = 0; index < _weights.size(); ++index) {
+        for (size_t side = 0; side < 2; ++side) {
+            // 4 channels of +-15 at a master volume of up to 8 fit in 16 bits after scaling by 64
+            const bool audible = _powered && (panning[side] & (1 << index));
+            _weights[index][side] = audible ? volumes[side] * 64 : 0;
+        }
+    }
+}
+
+void apu::run_channels(std::uint64_t cycle, dword cycles) {
+    if (_synthesis == synthesis::oversampled) {
+        _square1.run(cycles);
+        _square2.run(cycles);
+        _noise.run(cycles);
+    } else {
+        run_edges(_square1, 0, cycle, cycles);
+        run_edges(_square2, 1, cycle, cycles);
+        run_edges(_noise, 3, cycle, cycles);
+    }
+
+    // the wave channel is point sampled in both modes
+    _wave.run(cycles);
+}
+
+template <typename Channel>
+void apu::run_edges(Channel& channel, size_t index, std::uint64_t cycle, dword cycles) {
+    // only the steps of the channel are visited, the level is constant between them
+    while (cycles >= channel.next_step()) {
+        const dword step = channel.next_step();
+        channel.run(step);
+        cycle += step;
+        cycles -= step;
+        update_level(index, channel.output(), cycle);
+    }
+
+    channel.run(cycles);
+}
+
+void apu::update_level(size_t index, int output, std::uint64_t cycle) {
+    for (size_t side = 0; side < 2; ++side) {
+        const int level = output * _weights[index][side];
+
+        if (level == _levels[index][side]) continue;
+
+        // the position of the cycle from the first unread sample, in samples and a fraction of a sample
+        const std::uint64_t time = cycle * audio_timing::sample_rate - _first_unread_sample * audio_timing::cycles_per_second;
+        const dword position = static_cast<dword>(time / audio_timing::cycles_per_second);
+        const dword phase = static_cast<dword>(((time % audio_timing::cycles_per_second) << blep_buffer::phase_bits) / audio_timing::cycles_per_second);
+
+        _bleps[side].add_delta(position, phase, level - _levels[index][side]);
+        _levels[index][side] = level;
+    }
+}
+
+void apu::update_levels(std::uint64_t cycle) {
+    if (_synthesis != synthesis::band_limited) return;
+
+    update_level(0, _square1.output(), cycle);
+    update_level(1, _square2.output(), cycle);
+    update_level(2, _wave.output(), cycle);
+    update_level(3, _noise.output(), cycle);
+}
+
+void apu::clock_sequencer() {
+    if (!_powered) return;
+
+    // length on even steps, sweep on steps 2 and 6, envelope on step 7
+    if (_sequencer_step % 2 == 0) {
+        _square1.clock_length();
+        _square2.clock_length();
+        _wave.clock_length();
+        _noise.clock_length();
+    }
+
+    if (_sequencer_step == 2 || _sequencer_step == 6) {
+        _square1.clock_sweep();
+    }
+
+    if (_sequencer_step == 7) {
+        _square1.clock_envelope();
+        _square2.clock_envelope();
+        _noise.clock_envelope();
+    }
+
+    _sequencer_step = (_sequencer_step + 1) % 8;
+}
+
+void apu::sample_point(std::uint64_t cycle) {
+    if (_synthesis == synthesis::band_limited) {
+        update_level(2, _wave.output(), cycle);
+        return;
+    }
+
+    const std::array<int, 4> outputs = { _square1.output(), _square2.output(), _wave.output(), _noise.output() };
+
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        _oversampled_sum[0] += outputs[i] * _weights[i][0];
+        _oversampled_sum[1] += outputs[i] * _weights[i][1];
+    }
+
+    if (++_oversampled_count < oversampling) return;
+
+    for (int& sum : _oversampled_sum) {
+        _samples.push_back(static_cast<sample>(sum / static_cast<int>(oversampling)));
+        sum = 0;
+    }
+
+    _oversampled_count = 0;
+}
+
+void apu::read_band_limited(std::uint64_t to_cycle) {
+    // the samples before the cycle can't be changed by later deltas
+    const std::uint64_t end = to_cycle * audio_timing::sample_rate / audio_timing::cycles_per_second;
+    const dword count = static_cast<dword>(end - _first_unread_sample);
+    const size_t first = _samples.size();
+
+    _samples.resize(first + count * audio_timing::output_channels);
+    _bleps[0].read(count, _samples.data() + first, audio_timing::output_channels);
+    _bleps[1].read(count, _samples.data() + first + 1, audio_timing::output_channels);
+
+    _first_unread_sample = end;
+}
+
+void apu::synthesize(std::uint64_t to_cycle) {
+    size_t next_write = 0;
+
+    // everything in [_synth_cycle, to_cycle), the writes of a cycle come before its sample
+    while (true) {
+        const size_t first_write = next_write;
+
+        while (next_write < _writes.size() && _writes[next_write].cycle <= _synth_cycle) {
+            apply(_writes[next_write].address, _writes[next_write].value);
+            ++next_write;
+        }
+
+        if (next_write != first_write) update_levels(_synth_cycle);
+
+        if (_synth_cycle >= to_cycle) break;
+
+        if (_synth_cycle == _next_sequencer_cycle) {
+            clock_sequencer();
+            update_levels(_synth_cycle);
+            _next_sequencer_cycle += audio_timing::frame_sequencer_cycles;
+        }
+
+        // the sample cycle is rounded up
+        std::uint64_t sample_cycle = (_next_sample_time + _sample_rate - 1) / _sample_rate;
+
+        if (_synth_cycle == sample_cycle) {
+            sample_point(_synth_cycle);
+            _next_sample_time += audio_timing::cycles_per_second;
+            sample_cycle = (_next_sample_time + _sample_rate - 1) / _sample_rate;
+        }
+
+        std::uint64_t until = std::min({ to_cycle, _next_sequencer_cycle, sample_cycle });
+        if (next_write < _writes.size()) until = std::min(until, _writes[next_write].cycle);
+
+        run_channels(_synth_cycle, static_cast<dword>(until - _synth_cycle));
+        _synth_cycle = until;
+    }
+
+    _writes.clear();
+
+    if (_synthesis == synthesis::band_limited) {
+        read_band_limited(to_cycle);
+    }
+}
+
+void apu::tick(dword cycles) {
+    _cycle += cycles;
+
+    if (_cycle - _synth_cycle >= audio_timing::batch_cycles) {
+        flush();
+    }
+}
+
+void apu::flush() {
+    synthesize(_cycle);
+}
+
+const std::vector<sample>& apu::samples() const {
+    return _samples;
+}
+
+void apu::clear_samples() {
+    _samples.clear();
+}
+
+void apu::discard_samples(size_t keep) {
+    if (keep < _samples.size()) {
+        _samples.resize(keep);
+    }
+}
+
+size_t apu::heap_size() const {
+    return _writes.capacity() * sizeof(audio_write) + _samples.capacity() * sizeof(sample) +
+        _bleps[0].heap_size() + _bleps[1].heap_size();
+}
+
+void apu::restart_output() {
+    const std::uint64_t cycles_per_second = audio_timing::cycles_per_second;
+
+    // the first sample point in or after the synthesized cycle (a point is in the cycle its time is rounded up to)
+    const std::uint64_t points = _synth_cycle == 0 ? 0 : (_synth_cycle - 1) * _sample_rate / cycles_per_second + 1;
+    _next_sample_time = points * cycles_per_second;
+    _first_unread_sample = _synth_cycle * audio_timing::sample_rate / cycles_per_second;
+
+    for (blep_buffer& blep : _bleps) {
+        blep.clear();
+    }
+
+    for (auto& levels : _levels) {
+        levels.fill(0);
+    }
+
+    _oversampled_sum.fill(0);
+    _oversampled_count = static_cast<dword>(points % oversampling);
+    update_levels(_synth_cycle);
+}
+
+void apu::save(state::snapshot& snapshot) const {
+    snapshot.write(_registers, _cycle);
+    snapshot.write_vector(_writes, [](state::snapshot& image, const audio_write& write) {
+        image.write(write.cycle, write.address, write.value);
+    });
+    snapshot.write(_synth_cycle, _next_sequencer_cycle, _sequencer_step);
+    snapshot.write(_powered, _panning, _master_volume, _weights);
+    _square1.save(snapshot);
+    _square2.save(snapshot);
+    _wave.save(snapshot);
+    _noise.save(snapshot);
+
+    // the samples of the synthesis the state was saved with
+    snapshot.write(_synthesis, _next_sample_time);
+
+    for (const blep_buffer& blep : _bleps) {
+        blep.save(snapshot);
+    }
+
+    snapshot.write(_levels, _first_unread_sample, _oversampled_sum, _oversampled_count);
+}
+
+void apu::load(state::snapshot& snapshot) {
+    snapshot.read(_registers, _cycle);
+    snapshot.read_vector(_writes, [](state::snapshot& image, audio_write& write) {
+        image.read(write.cycle, write.address, write.value);
+        state::snapshot::check_below(static_cast<word>(write.address - first_register), last_register - first_register + 1);
+    });
+    snapshot.read(_synth_cycle, _next_sequencer_cycle, _sequencer_step);
+    state::snapshot::check_below(_sequencer_step, 8);
+    snapshot.read(_powered, _panning, _master_volume, _weights);
+    _square1.load(snapshot);
+    _square2.load(snapshot);
+    _wave.load(snapshot);
+    _noise.load(snapshot);
+
+    synthesis saved_synthesis;
+    snapshot.read_enum(saved_synthesis, synthesis::oversampled);
+    snapshot.read(_next_sample_time);
+
+    for (blep_buffer& blep : _bleps) {
+        blep.load(snapshot);
+    }
+
+    snapshot.read(_levels, _first_unread_sample, _oversampled_sum, _oversampled_count);
+    state::snapshot::check_below(_oversampled_count, oversampling);
+
+    if (saved_synthesis != _synthesis) {
+        restart_output();
+    }
+}
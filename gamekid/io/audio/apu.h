@@ -0,0 +1,116 @@
+#pragma once
+#include "square_channel.h"
+#include "wave_channel.h"
+#include "noise_channel.h"
+#include "blep_buffer.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace gamekid::io::audio {
+    using sample = std::int16_t;
+
+    enum class synthesis {
+        // the square and noise channels add band-limited steps at their edges
+        band_limited,
+        // every channel is point sampled at 4x the sample rate and averaged (aliases, slower)
+        oversampled
+    };
+
+    struct audio_write {
+        std::uint64_t cycle;
+        word address;
+        byte value;
+    };
+
+    // The sound registers (NR10 - NR52) and the wave pattern ram.
+    // The apu is not stepped with the cpu: stores are timestamped and logged,
+    // and the samples of a whole batch are synthesized at once (once per frame,
+    // or when NR52 is read and the channel status has to be up to date).
+    class apu {
+    private:
+        std::array<byte, 0x30> _registers{};
+        std::uint64_t _cycle = 0;
+        std::vector<audio_write> _writes;
+
+        // synthesis state, behind _cycle until the batch is synthesized
+        synthesis _synthesis;
+        std::uint64_t _synth_cycle = 0;
+        std::uint64_t _next_sequencer_cycle;
+        byte _sequencer_step = 0;
+        // in 1/sample_rate cycles so the sample times don't drift
+        std::uint64_t _next_sample_time = 0;
+        dword _sample_rate;
+        bool _powered = false;
+        byte _panning = 0;
+        byte _master_volume = 0;
+        // the multiplier of every channel on the left and right outputs (NR50, NR51 and NR52)
+        std::array<std::array<int, 2>, 4> _weights{};
+        square_channel _square1{ true };
+        square_channel _square2{ false };
+        wave_channel _wave;
+        noise_channel _noise;
+
+        std::vector<sample> _samples;
+
+        // band limited synthesis, the last level of every channel on each output
+        std::array<blep_buffer, 2> _bleps;
+        std::array<std::array<int, 2>, 4> _levels{};
+        std::uint64_t _first_unread_sample = 0;
+
+        // oversampled synthesis
+        std::array<int, 2> _oversampled_sum{};
+        dword _oversampled_count = 0;
+
+        void apply(word address, byte value);
+        void update_weights();
+        void run_channels(std::uint64_t cycle, dword cycles);
+        template <typename Channel>
+        void run_edges(Channel& channel, size_t index, std::uint64_t cycle, dword cycles);
+        void update_level(size_t index, int output, std::uint64_t cycle);
+        void update_levels(std::uint64_t cycle);
+        void clock_sequencer();
+        void sample_point(std::uint64_t cycle);
+        void read_band_limited(std::uint64_t to_cycle);
+        void synthesize(std::uint64_t to_cycle);
+        // starts the samples again from the synthesized cycle
+        void restart_output();
+    public:
+        static const word first_register = 0xFF10;
+        static const word last_register = 0xFF3F;
+
+        explicit apu(synthesis mode = synthesis::band_limited);
+
+        apu(const apu&) = delete;
+        apu& operator=(const apu&) = delete;
+
+        byte load(word address);
+        void store(word address, byte value);
+
+        // Advances the apu clock, the samples are synthesized once a batch is complete
+        void tick(dword cycles);
+
+        // Synthesizes everything up to the current cycle
+        void flush();
+
+        // Interleaved stereo (left, right) samples at audio_timing::sample_rate
+        const std::vector<sample>& samples() const;
+        void clear_samples();
+
+        // Drops the samples after the given amount (of sample values)
+        void discard_samples(size_t keep);
+
+        // The memory of the sample and write buffers, in bytes
+        size_t heap_size() const;
+
+        synthesis mode() const {
+            return _synthesis;
+        }
+
+        // The registers, the channels and the synthesis, the samples are not a part of the state.
+        // The apu keeps its own synthesis mode: a state of the other one continues from its channels
+        // and its samples start again from silence
+        void save(state::snapshot& snapshot) const;
+        void load(state::snapshot& snapshot);
+    };
+}
@@ -0,0 +1,13 @@
+#include "apu_register_cell.h"
+
+gamekid::io::audio::apu_register_cell::apu_register_cell(apu& apu, word address) :
+_apu(apu), _address(address) {
+}
+
+byte gamekid::io::audio::apu_register_cell::load() {
+    return _apu.load(_address);
+}
+
+void gamekid::io::audio::apu_register_cell::store(byte value) {
+    _apu.store(_address, value);
+}
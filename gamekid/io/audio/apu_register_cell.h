@@ -0,0 +1,16 @@
+#pragma once
+#include "apu.h"
+#include "gamekid/memory/cell.h"
+
+namespace gamekid::io::audio {
+    // A sound register (NR10 - NR52) or a byte of the wave pattern ram, which is kept in the apu
+    class apu_register_cell : public memory::cell {
+    private:
+        apu& _apu;
+        word _address;
+    public:
+        apu_register_cell(apu& apu, word address);
+        byte load() override;
+        void store(byte value) override;
+    };
+}
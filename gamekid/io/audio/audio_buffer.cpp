@@ -0,0 +1,47 @@
+#include "audio_buffer.h"
+#include "audio_timing.h"
+
+using gamekid::io::audio::audio_buffer;
+using gamekid::io::audio::audio_telemetry;
+
+audio_buffer::audio_buffer(size_t frames) : _ring(frames * audio_timing::output_channels) {
+}
+
+void audio_buffer::push(const sample* samples, size_t count) {
+    // a partial frame would swap the channels
+    const size_t free = (_ring.capacity() - _ring.size()) / audio_timing::output_channels * audio_timing::output_channels;
+    const size_t written = _ring.write(samples, std::min(count, free));
+
+    if (written < count) {
+        _overruns += static_cast<dword>((count - written) / audio_timing::output_channels);
+    }
+}
+
+void audio_buffer::pop(sample* out, size_t count) {
+    const size_t read = _ring.read(out, count);
+
+    if (read >= audio_timing::output_channels) {
+        _last = { out[read - 2], out[read - 1] };
+    }
+
+    if (read == count) return;
+
+    _underruns += static_cast<dword>((count - read) / audio_timing::output_channels);
+
+    // the last frame decays by 1/16 every frame
+    for (size_t i = read; i + 1 < count; i += audio_timing::output_channels) {
+        _last[0] -= _last[0] / 16 + (_last[0] > 0) - (_last[0] < 0);
+        _last[1] -= _last[1] / 16 + (_last[1] > 0) - (_last[1] < 0);
+        out[i] = _last[0];
+        out[i + 1] = _last[1];
+    }
+}
+
+audio_telemetry audio_buffer::telemetry() const {
+    return {
+        _ring.size() / audio_timing::output_channels,
+        _ring.capacity() / audio_timing::output_channels,
+        _underruns.load(),
+        _overruns.load()
+    };
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "apu.h"
+#include <gamekid/utils/spsc_ring.h>
+#include <array>
+#include <atomic>
+
+namespace gamekid::io::audio {
+    struct audio_telemetry {
+        // in stereo frames
+        size_t fill;
+        size_t capacity;
+        // frames the device asked for that were not there
+        dword underruns;
+        // frames dropped because the buffer was full
+        dword overruns;
+    };
+
+    // Interleaved stereo samples from the emulation thread to the audio device callback.
+    // Neither side blocks: a full buffer drops the newest samples, and an empty buffer
+    // fades the last played frame out instead of clicking.
+    class audio_buffer {
+    private:
+        utils::spsc_ring<sample> _ring;
+        std::atomic<dword> _underruns{ 0 };
+        std::atomic<dword> _overruns{ 0 };
+
+        // consumer side
+        std::array<sample, 2> _last{};
+    public:
+        explicit audio_buffer(size_t frames);
+
+        // Producer: pushes count samples (whole frames)
+        void push(const sample* samples, size_t count);
+
+        // Consumer: always fills count samples
+        void pop(sample* out, size_t count);
+
+        audio_telemetry telemetry() const;
+    };
+}
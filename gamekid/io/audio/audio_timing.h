@@ -0,0 +1,14 @@
+#pragma once
+#include <gamekid/utils/types.h>
+#include <gamekid/io/video/lcd_timing.h>
+
+namespace gamekid::io::audio::audio_timing {
+    const dword
+        cycles_per_second = video::lcd_timing::cycles_per_second,
+        sample_rate = 48000,
+        output_channels = 2,
+        // length at 256hz, sweep at 128hz and envelope at 64hz are derived from a 512hz sequencer
+        frame_sequencer_cycles = cycles_per_second / 512,
+        // the writes are collected and synthesized once per video frame
+        batch_cycles = video::lcd_timing::cycles_per_frame;
+}
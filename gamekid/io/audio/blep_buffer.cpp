@@ -0,0 +1,86 @@
+#include "blep_buffer.h"
+#include <gamekid/state/snapshot.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using gamekid::io::audio::blep_buffer;
+
+const dword kernel_phase_bits = 5;
+const dword kernel_phases = 1 << kernel_phase_bits;
+const dword kernel_bits = 15;
+
+using kernel = std::array<std::array<std::int32_t, blep_buffer::kernel_width>, kernel_phases>;
+
+// Blackman windowed sinc impulses for every sub-sample phase, each phase sums to exactly 1 << kernel_bits
+kernel create_kernel() {
+    const double pi = 3.14159265358979323846;
+    const double cutoff = 0.45;
+    const double half_width = blep_buffer::kernel_width / 2.0;
+    kernel result{};
+
+    for (dword phase = 0; phase < kernel_phases; ++phase) {
+        std::array<double, blep_buffer::kernel_width> taps{};
+        double total = 0;
+
+        for (dword i = 0; i < blep_buffer::kernel_width; ++i) {
+            const double x = i + 1 - half_width - static_cast<double>(phase) / kernel_phases;
+            const double sinc = x == 0 ? 1 : std::sin(2 * pi * cutoff * x) / (2 * pi * cutoff * x);
+            const double window = 0.42 + 0.5 * std::cos(pi * x / half_width) + 0.08 * std::cos(2 * pi * x / half_width);
+
+            taps[i] = sinc * window;
+            total += taps[i];
+        }
+
+        std::int32_t sum = 0;
+        for (dword i = 0; i < blep_buffer::kernel_width; ++i) {
+            result[phase][i] = static_cast<std::int32_t>(std::lround(taps[i] / total * (1 << kernel_bits)));
+            sum += result[phase][i];
+        }
+
+        // the rounding error goes to the center tap so a step is exact after integration
+        result[phase][blep_buffer::kernel_width / 2] += (1 << kernel_bits) - sum;
+    }
+
+    return result;
+}
+
+void blep_buffer::add_delta(dword position, dword phase, int delta) {
+    static const kernel impulses = create_kernel();
+
+    if (_buffer.size() < position + kernel_width) {
+        _buffer.resize(position + kernel_width, 0);
+    }
+
+    const auto& impulse = impulses[phase >> (phase_bits - kernel_phase_bits)];
+    std::int64_t* out = _buffer.data() + position;
+
+    for (dword i = 0; i < kernel_width; ++i) {
+        out[i] += static_cast<std::int64_t>(delta) * impulse[i];
+    }
+}
+
+void blep_buffer::read(dword count, std::int16_t* out, size_t stride) {
+    if (_buffer.size() < count) {
+        _buffer.resize(count, 0);
+    }
+
+    for (dword i = 0; i < count; ++i) {
+        _sum += _buffer[i];
+
+        const std::int64_t value = _sum >> kernel_bits;
+        out[i * stride] = static_cast<std::int16_t>(std::clamp<std::int64_t>(value, INT16_MIN, INT16_MAX));
+    }
+
+    _buffer.erase(_buffer.begin(), _buffer.begin() + count);
+}
+
+void blep_buffer::save(state::snapshot& snapshot) const {
+    snapshot.write(_sum);
+    snapshot.write_vector(_buffer);
+}
+
+void blep_buffer::load(state::snapshot& snapshot) {
+    snapshot.read(_sum);
+    snapshot.read_vector(_buffer);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <gamekid/utils/types.h>
+#include <cstdint>
+#include <vector>
+
+namespace gamekid::state {
+    class snapshot;
+}
+
+namespace gamekid::io::audio {
+
+    // Accumulates band-limited steps and integrates them into samples.
+    // A level change is added as a windowed sinc impulse at its sub-sample position,
+    // so the cost depends on the number of changes and not on the sample rate.
+    class blep_buffer {
+    private:
+        std::vector<std::int64_t> _buffer;
+        std::int64_t _sum = 0;
+    public:
+        static const dword kernel_width = 16;
+        static const dword phase_bits = 16;
+
+        // position is the sample index (from the first unread sample), phase is the fraction
+        // of a sample in phase_bits bits
+        void add_delta(dword position, dword phase, int delta);
+
+        // Integrates count samples into out (every stride samples) and removes them from the buffer
+        void read(dword count, std::int16_t* out, size_t stride);
+
+        // Drops the steps which were not read, the output starts again from silence
+        void clear() {
+            _buffer.clear();
+            _sum = 0;
+        }
+
+        size_t heap_size() const {
+            return _buffer.capacity() * sizeof(std::int64_t);
+        }
+
+        void save(state::snapshot& snapshot) const;
+        void load(state::snapshot& snapshot);
+    };
+}
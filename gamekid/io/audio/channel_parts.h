@@ -0,0 +1,72 @@
+#pragma once
+#include <gamekid/utils/types.h>
+#include <gamekid/state/snapshot.h>
+
+namespace gamekid::io::audio {
+
+    // Turns the channel off when it reaches 0 (if enabled in NRx4)
+    class length_counter {
+    private:
+        dword _max;
+        dword _value = 0;
+        bool _enabled = false;
+    public:
+        explicit length_counter(dword max) : _max(max) {}
+
+        void load(byte length) { _value = _max - length; }
+        void enabled(bool value) { _enabled = value; }
+
+        void trigger() {
+            if (_value == 0) _value = _max;
+        }
+
+        // returns false when the channel should be turned off
+        bool clock() {
+            if (!_enabled || _value == 0) return true;
+            return --_value != 0;
+        }
+
+        // the maximum is a part of the channel
+        void save(state::snapshot& snapshot) const { snapshot.write(_value, _enabled); }
+        void load(state::snapshot& snapshot) {
+            snapshot.read(_value, _enabled);
+            state::snapshot::check_below(_value, _max + 1);
+        }
+    };
+
+    // The volume envelope of NRx2
+    class envelope {
+    private:
+        byte _register = 0;
+        byte _volume = 0;
+        byte _timer = 0;
+    public:
+        void store(byte value) { _register = value; }
+
+        // the dac is off when the initial volume is 0 and the envelope decreases
+        bool dac_enabled() const { return (_register & 0xF8) != 0; }
+        byte volume() const { return _volume; }
+
+        void trigger() {
+            _volume = _register >> 4;
+            _timer = _register & 0b111;
+        }
+
+        void clock() {
+            const byte period = _register & 0b111;
+            if (period == 0 || _timer == 0 || --_timer != 0) return;
+
+            _timer = period;
+
+            if ((_register & 0b1000) && _volume < 15) ++_volume;
+            else if (!(_register & 0b1000) && _volume > 0) --_volume;
+        }
+
+        void save(state::snapshot& snapshot) const { snapshot.write(_register, _volume, _timer); }
+        void load(state::snapshot& snapshot) {
+            snapshot.read(_register, _volume, _timer);
+            state::snapshot::check_below(_volume, 16);
+            state::snapshot::check_below(_timer, 8);
+        }
+    };
+}
@@ -0,0 +1,94 @@
+#include "noise_channel.h"
+
+using gamekid::io::audio::noise_channel;
+
+noise_channel::noise_channel() : _timer(period()) {
+}
+
+dword noise_channel::period() const {
+    const byte divisor_code = _polynomial & 0b111;
+    const dword divisor = divisor_code ? divisor_code * 16 : 8;
+
+    return divisor << (_polynomial >> 4);
+}
+
+void noise_channel::store(byte index, byte value) {
+    switch (index) {
+    case 1:
+        _length.load(value & 0x3F);
+        break;
+    case 2:
+        _envelope.store(value);
+        if (!_envelope.dac_enabled()) _enabled = false;
+        break;
+    case 3:
+        _polynomial = value;
+        break;
+    case 4:
+        _length.enabled(value & 0x40);
+
+        if (value & 0x80) {
+            _enabled = _envelope.dac_enabled();
+            _length.trigger();
+            _envelope.trigger();
+            _timer = period();
+            _lfsr = 0x7FFF;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void noise_channel::step() {
+    const word feedback = (_lfsr ^ (_lfsr >> 1)) & 1;
+    _lfsr = (_lfsr >> 1) | (feedback << 14);
+
+    // 7 bit mode
+    if (_polynomial & 0b1000) {
+        _lfsr = (_lfsr & ~(1 << 6)) | (feedback << 6);
+    }
+}
+
+void noise_channel::run(dword cycles) {
+    // the register has to be shifted once per period, there is no shortcut
+    while (cycles >= _timer) {
+        cycles -= _timer;
+        step();
+        _timer = period();
+    }
+
+    _timer -= cycles;
+}
+
+void noise_channel::clock_length() {
+    if (!_length.clock()) _enabled = false;
+}
+
+void noise_channel::clock_envelope() {
+    _envelope.clock();
+}
+
+bool noise_channel::enabled() const {
+    return _enabled;
+}
+
+int noise_channel::output() const {
+    if (!_enabled) return 0;
+    return (_lfsr & 1) ? -_envelope.volume() : _envelope.volume();
+}
+
+void noise_channel::save(state::snapshot& snapshot) const {
+    snapshot.write(_enabled);
+    _length.save(snapshot);
+    _envelope.save(snapshot);
+    snapshot.write(_polynomial, _timer, _lfsr);
+}
+
+void noise_channel::load(state::snapshot& snapshot) {
+    snapshot.read(_enabled);
+    _length.load(snapshot);
+    _envelope.load(snapshot);
+    snapshot.read(_polynomial, _timer, _lfsr);
+    state::snapshot::check_below(_lfsr, 0x8000);
+}
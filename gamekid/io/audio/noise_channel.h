@@ -0,0 +1,37 @@
+#pragma once
+#include "channel_parts.h"
+
+namespace gamekid::io::audio {
+
+    // Sound mode 4 (NR41-NR44), a linear feedback shift register clocked by NR43
+    class noise_channel {
+    private:
+        bool _enabled = false;
+        length_counter _length{ 64 };
+        envelope _envelope;
+        byte _polynomial = 0;
+        dword _timer;
+        word _lfsr = 0x7FFF;
+
+        dword period() const;
+        void step();
+    public:
+        noise_channel();
+
+        // index is the register number in the channel (NR40 - NR44)
+        void store(byte index, byte value);
+
+        void run(dword cycles);
+
+        // The cycles until the next step, the output can only change there
+        dword next_step() const { return _timer; }
+        void clock_length();
+        void clock_envelope();
+
+        bool enabled() const;
+        int output() const;
+
+        void save(state::snapshot& snapshot) const;
+        void load(state::snapshot& snapshot);
+    };
+}
@@ -0,0 +1,68 @@
+#include "resampler.h"
+#include <algorithm>
+#include <cmath>
+
+using gamekid::io::audio::resampler;
+
+double gamekid::io::audio::dynamic_ratio(size_t fill, size_t capacity, double max_deviation) {
+    const double half = capacity / 2.0;
+    const double error = std::clamp((half - fill) / half, -1.0, 1.0);
+
+    return 1 + max_deviation * error;
+}
+
+resampler::resampler() {
+    for (auto& channel : _input) {
+        channel.assign(history_frames, 0);
+    }
+}
+
+void resampler::process(const sample* samples, size_t frames, double ratio, std::vector<sample>& out) {
+    for (size_t channel = 0; channel < _input.size(); ++channel) {
+        std::vector<float>& input = _input[channel];
+        input.reserve(history_frames + frames);
+
+        for (size_t i = 0; i < frames; ++i) {
+            input.push_back(samples[i * 2 + channel]);
+        }
+    }
+
+    // every output frame needs one input frame before it and two after it
+    const double step = 1 / ratio;
+    const double end = static_cast<double>(_input[0].size() - 2);
+    const size_t count = _position < end ? static_cast<size_t>(std::ceil((end - _position) / step)) : 0;
+    const size_t first = out.size();
+    out.resize(first + count * 2);
+
+    // one channel at a time so the loop body is the same for every frame
+    for (size_t channel = 0; channel < _input.size(); ++channel) {
+        const float* input = _input[channel].data();
+        sample* output = out.data() + first + channel;
+        double position = _position;
+
+        for (size_t i = 0; i < count; ++i, position += step) {
+            const size_t index = static_cast<size_t>(position);
+            const float t = static_cast<float>(position - index);
+            const float p0 = input[index - 1], p1 = input[index], p2 = input[index + 1], p3 = input[index + 2];
+
+            // catmull-rom spline through p1 and p2
+            const float a = -0.5f * p0 + 1.5f * p1 - 1.5f * p2 + 0.5f * p3;
+            const float b = p0 - 2.5f * p1 + 2 * p2 - 0.5f * p3;
+            const float c = -0.5f * p0 + 0.5f * p2;
+            const float value = ((a * t + b) * t + c) * t + p1;
+
+            output[i * 2] = static_cast<sample>(std::clamp(std::lround(value), -32768l, 32767l));
+        }
+    }
+
+    _position += count * step;
+
+    // keep the frames the next output frame depends on
+    const size_t keep_from = std::min(static_cast<size_t>(_position) - 1, _input[0].size() - history_frames);
+
+    for (auto& channel : _input) {
+        channel.erase(channel.begin(), channel.begin() + keep_from);
+    }
+
+    _position -= keep_from;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "apu.h"
+#include <array>
+#include <vector>
+
+namespace gamekid::io::audio {
+
+    // The output/input ratio that brings the device buffer back to half full.
+    // A fuller buffer gets fewer samples, the correction is at most max_deviation (0.5%)
+    // which is not audible as a pitch change.
+    double dynamic_ratio(size_t fill, size_t capacity, double max_deviation = 0.005);
+
+    // Resamples interleaved stereo samples by a ratio that can change on every call,
+    // with cubic hermite interpolation between the input frames.
+    class resampler {
+    private:
+        static const size_t history_frames = 3;
+
+        // the last frames of the previous call followed by the new input, per channel
+        std::array<std::vector<float>, 2> _input;
+        // the position of the next output frame, in input frames from the start of _input
+        double _position = 1;
+    public:
+        resampler();
+
+        // Appends about frames * ratio output frames to out
+        void process(const sample* samples, size_t frames, double ratio, std::vector<sample>& out);
+    };
+}
@@ -0,0 +1,141 @@
+#include "square_channel.h"
+#include <array>
+
+using gamekid::io::audio::square_channel;
+
+// 12.5%, 25%, 50% and 75% duty cycles
+const std::array<byte, 4> duty_patterns = { 0b00000001, 0b10000001, 0b10000111, 0b01111110 };
+
+square_channel::square_channel(bool has_sweep) : _has_sweep(has_sweep), _timer(period()) {
+}
+
+dword square_channel::period() const {
+    return (2048 - _frequency) * 4;
+}
+
+void square_channel::store(byte index, byte value) {
+    switch (index) {
+    case 0:
+        if (_has_sweep) _sweep_register = value;
+        break;
+    case 1:
+        _duty = value >> 6;
+        _length.load(value & 0x3F);
+        break;
+    case 2:
+        _envelope.store(value);
+        if (!_envelope.dac_enabled()) _enabled = false;
+        break;
+    case 3:
+        _frequency = (_frequency & 0x700) | value;
+        break;
+    case 4:
+        _frequency = (_frequency & 0xFF) | ((value & 0b111) << 8);
+        _length.enabled(value & 0x40);
+        if (value & 0x80) trigger();
+        break;
+    default:
+        break;
+    }
+}
+
+void square_channel::trigger() {
+    _enabled = _envelope.dac_enabled();
+    _length.trigger();
+    _envelope.trigger();
+    _timer = period();
+
+    if (_has_sweep) {
+        const byte sweep_period = (_sweep_register >> 4) & 0b111;
+        const byte shift = _sweep_register & 0b111;
+
+        _shadow_frequency = _frequency;
+        _sweep_timer = sweep_period ? sweep_period : 8;
+        _sweep_enabled = sweep_period != 0 || shift != 0;
+
+        // the overflow check is done immediately
+        if (shift != 0) next_sweep_frequency();
+    }
+}
+
+word square_channel::next_sweep_frequency() {
+    const word delta = _shadow_frequency >> (_sweep_register & 0b111);
+    const word frequency = (_sweep_register & 0b1000) ? _shadow_frequency - delta : _shadow_frequency + delta;
+
+    if (frequency > 2047) {
+        _enabled = false;
+    }
+
+    return frequency;
+}
+
+void square_channel::run(dword cycles) {
+    if (cycles < _timer) {
+        _timer -= cycles;
+        return;
+    }
+
+    // whole periods are skipped at once
+    cycles -= _timer;
+    const dword steps = 1 + cycles / period();
+    _duty_position = (_duty_position + steps) % 8;
+    _timer = period() - cycles % period();
+}
+
+void square_channel::clock_length() {
+    if (!_length.clock()) _enabled = false;
+}
+
+void square_channel::clock_envelope() {
+    _envelope.clock();
+}
+
+void square_channel::clock_sweep() {
+    if (!_has_sweep || _sweep_timer == 0 || --_sweep_timer != 0) return;
+
+    const byte sweep_period = (_sweep_register >> 4) & 0b111;
+    _sweep_timer = sweep_period ? sweep_period : 8;
+
+    if (!_sweep_enabled || sweep_period == 0) return;
+
+    const word frequency = next_sweep_frequency();
+
+    if (frequency <= 2047 && (_sweep_register & 0b111) != 0) {
+        _shadow_frequency = frequency;
+        _frequency = frequency;
+        next_sweep_frequency();
+    }
+}
+
+bool square_channel::enabled() const {
+    return _enabled;
+}
+
+int square_channel::output() const {
+    if (!_enabled) return 0;
+
+    const bool high = (duty_patterns[_duty] >> (7 - _duty_position)) & 1;
+    return high ? _envelope.volume() : -_envelope.volume();
+}
+
+void square_channel::save(state::snapshot& snapshot) const {
+    snapshot.write(_enabled);
+    _length.save(snapshot);
+    _envelope.save(snapshot);
+    snapshot.write(_duty, _duty_position, _frequency, _timer);
+    snapshot.write(_sweep_register, _sweep_enabled, _sweep_timer, _shadow_frequency);
+}
+
+void square_channel::load(state::snapshot& snapshot) {
+    snapshot.read(_enabled);
+    _length.load(snapshot);
+    _envelope.load(snapshot);
+    snapshot.read(_duty, _duty_position, _frequency, _timer);
+    snapshot.read(_sweep_register, _sweep_enabled, _sweep_timer, _shadow_frequency);
+
+    state::snapshot::check_below(_duty, duty_patterns.size());
+    state::snapshot::check_below(_duty_position, 8);
+    state::snapshot::check_below(_frequency, 2048);
+    state::snapshot::check_below(_shadow_frequency, 2048);
+    state::snapshot::check_below(_sweep_timer, 9);
+}
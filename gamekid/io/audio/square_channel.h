@@ -0,0 +1,51 @@
+#pragma once
+#include "channel_parts.h"
+
+namespace gamekid::io::audio {
+
+    // Sound mode 1 and 2 (NR10-NR14, NR21-NR24), channel 2 has no sweep
+    class square_channel {
+    private:
+        bool _has_sweep;
+        bool _enabled = false;
+        length_counter _length{ 64 };
+        envelope _envelope;
+        byte _duty = 0;
+        byte _duty_position = 0;
+        word _frequency = 0;
+        dword _timer;
+
+        // sweep (NR10)
+        byte _sweep_register = 0;
+        bool _sweep_enabled = false;
+        byte _sweep_timer = 0;
+        word _shadow_frequency = 0;
+
+        dword period() const;
+        word next_sweep_frequency();
+        void trigger();
+    public:
+        explicit square_channel(bool has_sweep);
+
+        // index is the register number in the channel (NRx0 - NRx4)
+        void store(byte index, byte value);
+
+        // Advances the duty timer by the given amount of cycles
+        void run(dword cycles);
+
+        // The cycles until the next step, the output can only change there
+        dword next_step() const { return _timer; }
+
+        void clock_length();
+        void clock_envelope();
+        void clock_sweep();
+
+        bool enabled() const;
+
+        // The output level between -15 and 15
+        int output() const;
+
+        void save(state::snapshot& snapshot) const;
+        void load(state::snapshot& snapshot);
+    };
+}
@@ -0,0 +1,94 @@
+#include "wave_channel.h"
+
+using gamekid::io::audio::wave_channel;
+
+wave_channel::wave_channel() : _timer(period()) {
+}
+
+dword wave_channel::period() const {
+    return (2048 - _frequency) * 2;
+}
+
+void wave_channel::store(byte index, byte value) {
+    switch (index) {
+    case 0:
+        _dac_enabled = value & 0x80;
+        if (!_dac_enabled) _enabled = false;
+        break;
+    case 1:
+        _length.load(value);
+        break;
+    case 2: {
+        // mute, 100%, 50%, 25%
+        const byte shifts[] = { 4, 0, 1, 2 };
+        _volume_shift = shifts[(value >> 5) & 0b11];
+        break;
+    }
+    case 3:
+        _frequency = (_frequency & 0x700) | value;
+        break;
+    case 4:
+        _frequency = (_frequency & 0xFF) | ((value & 0b111) << 8);
+        _length.enabled(value & 0x40);
+
+        if (value & 0x80) {
+            _enabled = _dac_enabled;
+            _length.trigger();
+            _timer = period();
+            _position = 0;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void wave_channel::store_wave(byte index, byte value) {
+    _wave_ram[index] = value;
+}
+
+void wave_channel::run(dword cycles) {
+    if (cycles < _timer) {
+        _timer -= cycles;
+        return;
+    }
+
+    cycles -= _timer;
+    const dword steps = 1 + cycles / period();
+    _position = (_position + steps) % 32;
+    _timer = period() - cycles % period();
+}
+
+void wave_channel::clock_length() {
+    if (!_length.clock()) _enabled = false;
+}
+
+bool wave_channel::enabled() const {
+    return _enabled;
+}
+
+int wave_channel::output() const {
+    if (!_enabled || _volume_shift == 4) return 0;
+
+    // the high nibble is played first
+    const byte pair = _wave_ram[_position / 2];
+    const int sample = (_position % 2) ? (pair & 0xF) : (pair >> 4);
+
+    return (sample * 2 - 15) / (1 << _volume_shift);
+}
+
+void wave_channel::save(state::snapshot& snapshot) const {
+    snapshot.write(_enabled, _dac_enabled);
+    _length.save(snapshot);
+    snapshot.write(_volume_shift, _frequency, _timer, _position, _wave_ram);
+}
+
+void wave_channel::load(state::snapshot& snapshot) {
+    snapshot.read(_enabled, _dac_enabled);
+    _length.load(snapshot);
+    snapshot.read(_volume_shift, _frequency, _timer, _position, _wave_ram);
+
+    state::snapshot::check_below(_volume_shift, 5);
+    state::snapshot::check_below(_frequency, 2048);
+    state::snapshot::check_below(_position, _wave_ram.size() * 2);
+}
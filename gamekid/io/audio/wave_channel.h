@@ -0,0 +1,36 @@
+#pragma once
+#include "channel_parts.h"
+#include <array>
+
+namespace gamekid::io::audio {
+
+    // Sound mode 3 (NR30-NR34), plays the 32 4-bit samples of the wave pattern ram
+    class wave_channel {
+    private:
+        bool _enabled = false;
+        bool _dac_enabled = false;
+        length_counter _length{ 256 };
+        byte _volume_shift = 4;
+        word _frequency = 0;
+        dword _timer;
+        byte _position = 0;
+        std::array<byte, 16> _wave_ram{};
+
+        dword period() const;
+    public:
+        wave_channel();
+
+        // index is the register number in the channel (NR30 - NR34)
+        void store(byte index, byte value);
+        void store_wave(byte index, byte value);
+
+        void run(dword cycles);
+        void clock_length();
+
+        bool enabled() const;
+        int output() const;
+
+        void save(state::snapshot& snapshot) const;
+        void load(state::snapshot& snapshot);
+    };
+}
@@ -0,0 +1,41 @@
+#include "catch_up.h"
+#include <gamekid/state/snapshot.h>
+#include <algorithm>
+
+using gamekid::io::catch_up;
+
+catch_up::catch_up(const std::uint64_t& master_cycle, std::function<void(dword)> run,
+    std::function<std::uint64_t()> cycles_to_event) :
+_master_cycle(master_cycle), _cycle(master_cycle), _next_event(never),
+_run(std::move(run)), _cycles_to_event(std::move(cycles_to_event)) {
+    reschedule();
+}
+
+void catch_up::sync() {
+    if (_cycle == _master_cycle) {
+        return;
+    }
+
+    // a component left alone for more than a dword of cycles is run in several batches
+    while (_cycle != _master_cycle) {
+        const std::uint64_t cycles = std::min<std::uint64_t>(_master_cycle - _cycle, UINT32_MAX);
+        _run(static_cast<dword>(cycles));
+        _cycle += cycles;
+    }
+
+    ++_syncs;
+    reschedule();
+}
+
+void catch_up::reschedule() {
+    const std::uint64_t cycles = _cycles_to_event();
+    _next_event = cycles == never ? never : _cycle + cycles;
+}
+
+void catch_up::save(state::snapshot& snapshot) const {
+    snapshot.write(_cycle, _next_event);
+}
+
+void catch_up::load(state::snapshot& snapshot) {
+    snapshot.read(_cycle, _next_event);
+}
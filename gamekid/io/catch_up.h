@@ -0,0 +1,56 @@
+#pragma once
+#include <gamekid/utils/types.h>
+#include <cstdint>
+#include <functional>
+
+namespace gamekid::state {
+    class snapshot;
+}
+
+namespace gamekid::io {
+
+    // A component (the lcd, the apu or the timer) which runs behind the cpu.
+    // The cpu only advances the master cycle count, the component is run up to it
+    // in one batch when it is observed, when its next event is due or at the end of the frame.
+    class catch_up {
+    private:
+        const std::uint64_t& _master_cycle;
+        std::uint64_t _cycle = 0;
+        std::uint64_t _next_event;
+        // runs the component for the given amount of cycles
+        std::function<void(dword)> _run;
+        // the cycles from the component's current cycle to its next event, or never
+        std::function<std::uint64_t()> _cycles_to_event;
+        dword _syncs = 0;
+    public:
+        static constexpr std::uint64_t never = UINT64_MAX;
+
+        catch_up(const std::uint64_t& master_cycle, std::function<void(dword)> run,
+            std::function<std::uint64_t()> cycles_to_event);
+
+        catch_up(const catch_up&) = delete;
+        catch_up& operator=(const catch_up&) = delete;
+
+        // Runs the component up to the master cycle
+        void sync();
+
+        // Recomputes the next event, after the state of the (synced) component changed
+        void reschedule();
+
+        void save(state::snapshot& snapshot) const;
+        void load(state::snapshot& snapshot);
+
+        bool due() const {
+            return _master_cycle >= _next_event;
+        }
+
+        std::uint64_t next_event() const {
+            return _next_event;
+        }
+
+        // The number of times the component was run
+        dword syncs() const {
+            return _syncs;
+        }
+    };
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <gamekid/utils/types.h>
+
+// The bits of IF and IE
+namespace gamekid::io::interrupts {
+    const byte
+        vblank = 0b00001,
+        lcd_stat = 0b00010,
+        timer = 0b00100,
+        serial = 0b01000,
+        joypad = 0b10000;
+}
@@ -1,5 +1,6 @@
 #include "joypad_cell.h"
 #include <gamekid/utils/bits.h>
+#include <gamekid/state/snapshot.h>
 
 using namespace gamekid::io;
 
@@ -26,45 +27,45 @@ namespace gamekid::io::joypad_bits {
     const byte P15 = 5;
 }
 
-void joypad_cell::store(byte value){
+byte joypad_cell::lines() const {
+    byte pressed = 0;
+
+    // a row is selected by a low P14 or P15
+    if (!gamekid::utils::bits::check_bit(_select, joypad_bits::P14)) {
+        pressed |= _pressed >> 4;
+    }
 
-    if (gamekid::utils::bits::check_bit(value, joypad_bits::P14)) {
-        set_byte_value(
-            joypad_button::right,
-            joypad_button::left,
-            joypad_button::up,
-            joypad_button::down
-        );
-    } else {
-        set_byte_value(
-            joypad_button::a,
-            joypad_button::b,
-            joypad_button::select,
-            joypad_button::start
-        );
+    if (!gamekid::utils::bits::check_bit(_select, joypad_bits::P15)) {
+        pressed |= _pressed & 0x0F;
     }
+
+    return ~pressed & 0x0F;
 }
 
-void joypad_cell::set_byte_value(joypad_button b1, joypad_button b2, 
-    joypad_button b3, joypad_button b4){
-    // load value
-    byte p1 = cell::load();
-    
-    // set value
-    p1 = gamekid::utils::bits::set_bit(p1, joypad_bits::P10, _status[b1]);
-    p1 = gamekid::utils::bits::set_bit(p1, joypad_bits::P11, _status[b2]);
-    p1 = gamekid::utils::bits::set_bit(p1, joypad_bits::P12, _status[b3]);
-    p1 = gamekid::utils::bits::set_bit(p1, joypad_bits::P13, _status[b4]);
-
-    // store value
-    cell::store(p1);
+byte joypad_cell::load() {
+    // the unused bits read as 1
+    return 0xC0 | _select | lines();
+}
+
+void joypad_cell::store(byte value){
+    _select = value & 0x30;
+}
+
+bool joypad_cell::get_status(joypad_button button) const {
+    return gamekid::utils::bits::check_bit(_pressed, static_cast<byte>(button));
 }
 
+bool joypad_cell::set_status(joypad_button button, bool status){
+    const byte old_lines = lines();
+    _pressed = gamekid::utils::bits::set_bit(_pressed, static_cast<byte>(button), status);
+
+    return (old_lines & ~lines()) != 0;
+}
 
-bool joypad_cell::get_status(joypad_button button){
-    return _status[button];
+void joypad_cell::save(state::snapshot& snapshot) const {
+    snapshot.write(_pressed, _select);
 }
 
-void joypad_cell::set_status(joypad_button button, bool status){
-    _status[button] = status;
+void joypad_cell::load(state::snapshot& snapshot) {
+    snapshot.read(_pressed, _select);
 }
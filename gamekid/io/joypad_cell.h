@@ -1,21 +1,35 @@
 #pragma once
-#include <map>
 #include <gamekid/utils/types.h>
 #include <gamekid/memory/cell.h>
 
+namespace gamekid::state {
+    class snapshot;
+}
+
 namespace gamekid::io {
     enum class joypad_button {
         a, b, select, start, 
         right, left, up, down
     };
 
+    // P1, the game selects the buttons or the directions (P14, P15) and reads the 
+    // input lines (P10 - P13). A line is low while a button of a selected row is pressed
     class joypad_cell : public memory::cell {
     private:
-        std::map<joypad_button, bool> _status;
-        void set_byte_value(joypad_button b1, joypad_button b2, joypad_button b3, joypad_button b4);
+        // a bit per button, in the order of joypad_button
+        byte _pressed = 0;
+        byte _select = 0x30;
+
+        byte lines() const;
     public:
+        byte load() override;
         void store(byte value) override;
-        bool get_status(joypad_button button);
-        void set_status(joypad_button button, bool status);
+        bool get_status(joypad_button button) const;
+
+        // Returns true if an input line went from high to low (the joypad interrupt)
+        bool set_status(joypad_button button, bool status);
+
+        void save(state::snapshot& snapshot) const;
+        void load(state::snapshot& snapshot);
     };
-}
\ No newline at end of file
+}
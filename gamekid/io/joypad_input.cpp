@@ -0,0 +1,116 @@
+#include "joypad_input.h"
+#include <gamekid/state/snapshot.h>
+#include <algorithm>
+
+using gamekid::io::joypad_input;
+using gamekid::io::joypad_event;
+
+joypad_input::joypad_input(size_t capacity) : _queue(capacity) {
+    _pending.reserve(capacity);
+    _future.reserve(capacity);
+}
+
+gamekid::io::joypad_cell& joypad_input::cell() {
+    return _cell;
+}
+
+bool joypad_input::post(const joypad_event& event) {
+    return _queue.push(event);
+}
+
+void joypad_input::schedule(joypad_event event) {
+    event.time = std::max(event.time, _cycle);
+    event.unit = input_time::cycle;
+
+    // after the events of the same cycle, so they are applied in the order they were posted
+    const auto position = std::upper_bound(_pending.begin(), _pending.end(), event,
+        [](const joypad_event& left, const joypad_event& right) { return left.time < right.time; });
+    _pending.insert(position, event);
+}
+
+void joypad_input::drain(dword frame) {
+    // the frames that started since the last drain
+    const auto started = std::stable_partition(_future.begin(), _future.end(),
+        [frame](const joypad_event& event) { return event.time <= frame; });
+
+    for (auto event = _future.begin(); event != started; ++event) {
+        schedule({ _cycle, input_time::cycle, event->button, event->pressed });
+    }
+
+    _future.erase(_future.begin(), started);
+
+    joypad_event event;
+
+    while (_queue.pop(event)) {
+        if (event.unit == input_time::cycle) {
+            schedule(event);
+        } else if (event.time <= frame) {
+            schedule({ _cycle, input_time::cycle, event.button, event.pressed });
+        } else {
+            _future.push_back(event);
+        }
+    }
+}
+
+bool joypad_input::tick(dword cycles) {
+    _cycle += cycles;
+
+    bool interrupt = false;
+    size_t applied = 0;
+
+    for (; applied < _pending.size() && _pending[applied].time <= _cycle; ++applied) {
+        const joypad_event& event = _pending[applied];
+        interrupt = _cell.set_status(event.button, event.pressed) || interrupt;
+
+        // with the cycle it was applied in, which may be later than its time
+        if (_recording) {
+            _recorded.push_back({ _cycle, input_time::cycle, event.button, event.pressed });
+        }
+    }
+
+    _pending.erase(_pending.begin(), _pending.begin() + applied);
+    return interrupt;
+}
+
+std::uint64_t joypad_input::next_event() const {
+    return _pending.empty() ? never : _pending.front().time;
+}
+
+void joypad_input::record(bool value) {
+    _recording = value;
+}
+
+const std::vector<gamekid::io::joypad_event>& joypad_input::recorded() const {
+    return _recorded;
+}
+
+size_t joypad_input::heap_size() const {
+    return (_queue.capacity() + _pending.capacity() + _future.capacity() + _recorded.capacity()) * sizeof(joypad_event);
+}
+
+namespace {
+    void write_event(gamekid::state::snapshot& snapshot, const joypad_event& event) {
+        snapshot.write(event.time, event.unit, event.button, event.pressed);
+    }
+
+    void read_event(gamekid::state::snapshot& snapshot, joypad_event& event) {
+        snapshot.read(event.time);
+        snapshot.read_enum(event.unit, gamekid::io::input_time::frame);
+        snapshot.read_enum(event.button, gamekid::io::joypad_button::down);
+        snapshot.read(event.pressed);
+    }
+}
+
+void joypad_input::save(state::snapshot& snapshot) const {
+    _cell.save(snapshot);
+    snapshot.write(_cycle);
+    snapshot.write_vector(_pending, write_event);
+    snapshot.write_vector(_future, write_event);
+}
+
+void joypad_input::load(state::snapshot& snapshot) {
+    _cell.load(snapshot);
+    snapshot.read(_cycle);
+    snapshot.read_vector(_pending, read_event);
+    snapshot.read_vector(_future, read_event);
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "joypad_cell.h"
+#include <gamekid/utils/spsc_ring.h>
+#include <cstdint>
+#include <vector>
+
+namespace gamekid::io {
+    enum class input_time {
+        // the master cycle count
+        cycle,
+        // the lcd frame count, the event is applied at the start of the frame
+        frame
+    };
+
+    struct joypad_event {
+        std::uint64_t time;
+        input_time unit;
+        joypad_button button;
+        bool pressed;
+    };
+
+    // The input of the joypad.
+    // Events are posted from any (single) thread through a wait-free queue, the emulation thread
+    // takes them only at scheduled points (the start of a frame) and applies each one when the cpu
+    // reaches its cycle. The applied events can be recorded with their exact cycles, posting the
+    // recording again replays the same input.
+    class joypad_input {
+    private:
+        joypad_cell _cell;
+        utils::spsc_ring<joypad_event> _queue;
+        std::uint64_t _cycle = 0;
+        // in cycles, in the order they are applied
+        std::vector<joypad_event> _pending;
+        // in frames that did not start yet
+        std::vector<joypad_event> _future;
+        bool _recording = false;
+        std::vector<joypad_event> _recorded;
+
+        void schedule(joypad_event event);
+    public:
+        static constexpr std::uint64_t never = UINT64_MAX;
+
+        explicit joypad_input(size_t capacity = 256);
+
+        joypad_input(const joypad_input&) = delete;
+        joypad_input& operator=(const joypad_input&) = delete;
+
+        // P1
+        joypad_cell& cell();
+
+        // Any thread: queues an event, returns false if the queue is full
+        bool post(const joypad_event& event);
+
+        // Emulation thread: takes the queued events, at the start of the given frame.
+        // Events which are late are applied in the current cycle
+        void drain(dword frame);
+
+        // Advances the input clock and applies the events that are due,
+        // returns true if an input line went from high to low (the joypad interrupt)
+        bool tick(dword cycles);
+
+        std::uint64_t cycle() const {
+            return _cycle;
+        }
+
+        // The cycle of the next pending event, or never
+        std::uint64_t next_event() const;
+
+        // The applied events are recorded (in cycles) while recording is on
+        void record(bool value);
+        const std::vector<joypad_event>& recorded() const;
+
+        // The memory of the queue, the scheduled events and the recording, in bytes
+        size_t heap_size() const;
+
+        // The lines and the scheduled events, the queue belongs to the thread that posts
+        void save(state::snapshot& snapshot) const;
+        void load(state::snapshot& snapshot);
+    };
+}
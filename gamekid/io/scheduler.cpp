@@ -0,0 +1,123 @@
+#include "scheduler.h"
+#include "interrupts.h"
+#include <gamekid/state/snapshot.h>
+
+using gamekid::io::scheduler;
+using gamekid::io::catch_up;
+
+scheduler::scheduler(video::lcd& lcd, audio::apu& apu, io::timer& timer, io::serial& serial,
+    joypad_input& joypad, std::function<void(byte)> request) :
+_lcd(lcd), _apu(apu), _timer(timer), _serial(serial), _joypad(joypad), _request_interrupt(std::move(request)),
+_lcd_sync(_cycle,
+    [this](dword cycles) { _lcd.tick(cycles); },
+    [this]() { return _lcd.enabled() ? _lcd.cycles_to_frame_end() : catch_up::never; }),
+_apu_sync(_cycle,
+    [this](dword cycles) { _apu.tick(cycles); },
+    []() { return catch_up::never; }),
+_timer_sync(_cycle,
+    [this](dword cycles) {
+        if (_timer.tick(cycles)) {
+            request_interrupt(interrupts::timer);
+        }
+    },
+    [this]() {
+        const std::uint64_t overflow = _timer.next_overflow();
+        return overflow == io::timer::never ? catch_up::never : overflow - _timer.cycle();
+    }),
+_serial_sync(_cycle,
+    [this](dword cycles) {
+        if (_serial.tick(cycles)) {
+            request_interrupt(interrupts::serial);
+        }
+    },
+    [this]() {
+        const std::uint64_t completion = _serial.completion();
+
+        if (completion == io::serial::never) {
+            return catch_up::never;
+        }
+
+        // a completion set by the link may already be due
+        return completion > _serial.cycle() ? completion - _serial.cycle() : 0;
+    }),
+_joypad_sync(_cycle,
+    [this](dword cycles) {
+        if (_joypad.tick(cycles)) {
+            request_interrupt(interrupts::joypad);
+        }
+    },
+    [this]() {
+        const std::uint64_t next = _joypad.next_event();
+
+        if (next == joypad_input::never) {
+            return catch_up::never;
+        }
+
+        // an event posted for the current cycle is due
+        return next > _joypad.cycle() ? next - _joypad.cycle() : 0;
+    }) {
+}
+
+void scheduler::request_interrupt(byte interrupt) {
+    if (_request_interrupt) {
+        _request_interrupt(interrupt);
+    }
+}
+
+void scheduler::sync_all() {
+    _lcd_sync.sync();
+    _apu_sync.sync();
+    _timer_sync.sync();
+    _serial_sync.sync();
+    _joypad_sync.sync();
+}
+
+namespace {
+    template <typename T>
+    void save_section(gamekid::state::snapshot& snapshot, gamekid::state::tag name, T& component) {
+        snapshot.begin_section(name);
+        component.save(snapshot);
+        snapshot.end_section();
+    }
+
+    template <typename T>
+    void load_section(gamekid::state::snapshot& snapshot, gamekid::state::tag name, T& component) {
+        snapshot.open_section(name);
+        component.load(snapshot);
+        snapshot.close_section();
+    }
+}
+
+void scheduler::save(state::snapshot& snapshot) {
+    save_section(snapshot, state::make_tag("LCD "), _lcd);
+    save_section(snapshot, state::make_tag("APU "), _apu);
+    save_section(snapshot, state::make_tag("TIMR"), _timer);
+    save_section(snapshot, state::make_tag("SERL"), _serial);
+    save_section(snapshot, state::make_tag("JOYP"), _joypad);
+
+    snapshot.begin_section(state::make_tag("SCHD"));
+    snapshot.write(_cycle);
+
+    for (const catch_up* sync : { &_lcd_sync, &_apu_sync, &_timer_sync, &_serial_sync, &_joypad_sync }) {
+        sync->save(snapshot);
+    }
+
+    snapshot.end_section();
+}
+
+void scheduler::load(state::snapshot& snapshot) {
+    load_section(snapshot, state::make_tag("LCD "), _lcd);
+    load_section(snapshot, state::make_tag("APU "), _apu);
+    load_section(snapshot, state::make_tag("TIMR"), _timer);
+    load_section(snapshot, state::make_tag("SERL"), _serial);
+    load_section(snapshot, state::make_tag("JOYP"), _joypad);
+
+    snapshot.open_section(state::make_tag("SCHD"));
+    snapshot.read(_cycle);
+
+    for (catch_up* sync : { &_lcd_sync, &_apu_sync, &_timer_sync, &_serial_sync, &_joypad_sync }) {
+        sync->load(snapshot);
+    }
+
+    snapshot.close_section();
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include "catch_up.h"
+#include "timer.h"
+#include "serial.h"
+#include "joypad_input.h"
+#include "video/lcd.h"
+#include "audio/apu.h"
+
+namespace gamekid::io {
+
+    // The master cycle count and the components which run behind the cpu.
+    // The lcd is woken at the end of its frame, the timer when TIMA overflows,
+    // the serial port when a transfer completes, the joypad when an input event is due
+    // and the apu only when its registers are accessed or the frame is synced.
+    class scheduler {
+    private:
+        std::uint64_t _cycle = 0;
+        video::lcd& _lcd;
+        audio::apu& _apu;
+        io::timer& _timer;
+        io::serial& _serial;
+        joypad_input& _joypad;
+        // requests the interrupts of the given IF bits
+        std::function<void(byte)> _request_interrupt;
+        catch_up _lcd_sync;
+        catch_up _apu_sync;
+        catch_up _timer_sync;
+        catch_up _serial_sync;
+        catch_up _joypad_sync;
+
+        void request_interrupt(byte interrupt);
+    public:
+        scheduler(video::lcd& lcd, audio::apu& apu, io::timer& timer, io::serial& serial,
+            joypad_input& joypad, std::function<void(byte)> request = {});
+
+        scheduler(const scheduler&) = delete;
+        scheduler& operator=(const scheduler&) = delete;
+
+        // Advances the master cycle count, the components whose event is due are caught up
+        void advance(dword cycles) {
+            _cycle += cycles;
+
+            if (_lcd_sync.due()) {
+                _lcd_sync.sync();
+            }
+
+            if (_timer_sync.due()) {
+                _timer_sync.sync();
+            }
+
+            if (_serial_sync.due()) {
+                _serial_sync.sync();
+            }
+
+            if (_joypad_sync.due()) {
+                _joypad_sync.sync();
+            }
+        }
+
+        // Catches up every component (at the end of a frame, before it is presented)
+        void sync_all();
+
+        // The components and the cycles they were caught up to
+        void save(state::snapshot& snapshot);
+        void load(state::snapshot& snapshot);
+
+        std::uint64_t cycle() const {
+            return _cycle;
+        }
+
+        video::lcd& lcd() {
+            return _lcd;
+        }
+
+        audio::apu& apu() {
+            return _apu;
+        }
+
+        io::timer& timer() {
+            return _timer;
+        }
+
+        io::serial& serial() {
+            return _serial;
+        }
+
+        joypad_input& joypad() {
+            return _joypad;
+        }
+
+        catch_up& lcd_sync() {
+            return _lcd_sync;
+        }
+
+        catch_up& apu_sync() {
+            return _apu_sync;
+        }
+
+        catch_up& timer_sync() {
+            return _timer_sync;
+        }
+
+        catch_up& serial_sync() {
+            return _serial_sync;
+        }
+
+        catch_up& joypad_sync() {
+            return _joypad_sync;
+        }
+    };
+}
@@ -0,0 +1,116 @@
+#include "serial.h"
+#include "io_registers.h"
+#include <gamekid/state/snapshot.h>
+
+using gamekid::io::serial;
+
+namespace {
+    const byte sc_start = 0x80;
+    const byte sc_internal_clock = 0x01;
+}
+
+serial::serial() : _transfer_start(never), _completion(never) {
+}
+
+byte serial::load(word address) const {
+    if (address == SB) {
+        return _sb;
+    }
+
+    // the unused bits of SC read as 1
+    return _sc | 0x7E;
+}
+
+void serial::store(word address, byte value) {
+    if (address == SB) {
+        _sb = value;
+        return;
+    }
+
+    _sc = value & (sc_start | sc_internal_clock);
+    _transfer_start = never;
+    _completion = never;
+
+    if (_sc != (sc_start | sc_internal_clock)) {
+        return;
+    }
+
+    if (_linked) {
+        _transfer_start = _cycle;
+    } else {
+        // nothing drives the line, it is pulled up
+        complete(0xFF, _cycle + transfer_cycles);
+    }
+}
+
+bool serial::tick(dword cycles) {
+    _cycle += cycles;
+
+    if (_cycle < _completion) {
+        return false;
+    }
+
+    _sb = _received;
+    _sc &= ~sc_start;
+    _completion = never;
+    return true;
+}
+
+bool serial::linked() const {
+    return _linked;
+}
+
+void serial::linked(bool value) {
+    _linked = value;
+}
+
+std::uint64_t serial::transfer_start() const {
+    return _transfer_start;
+}
+
+bool serial::armed() const {
+    return _sc == sc_start && _completion == never;
+}
+
+bool serial::active() const {
+    return (_sc & sc_start) != 0;
+}
+
+byte serial::data() const {
+    return _sb;
+}
+
+void serial::complete(byte value, std::uint64_t cycle) {
+    _received = value;
+    _completion = cycle;
+    _transfer_start = never;
+}
+
+gamekid::io::link_state serial::state() const {
+    return { _cycle, _transfer_start, _sb, armed(), active() };
+}
+
+void serial::link(const link_state& other) {
+    // the cycles the master's serial clock still needs, after the synchronization point
+    const auto delay = [](const link_state& master) -> std::uint64_t {
+        const std::uint64_t end = master.transfer_start + transfer_cycles;
+        return end > master.cycle ? end - master.cycle : 0;
+    };
+
+    if (_transfer_start != never) {
+        // the other end is not waiting for a transfer, the line is pulled up
+        const link_state self = state();
+        complete(other.armed ? other.data : 0xFF, _cycle + delay(self));
+    } else if (armed() && other.transfer_start != never) {
+        complete(other.data, _cycle + delay(other));
+    }
+}
+
+// being linked belongs to the connection, not to the state
+void serial::save(state::snapshot& snapshot) const {
+    snapshot.write(_cycle, _sb, _sc, _transfer_start, _completion, _received);
+}
+
+void serial::load(state::snapshot& snapshot) {
+    snapshot.read(_cycle, _sb, _sc, _transfer_start, _completion, _received);
+}
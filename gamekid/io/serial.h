@@ -0,0 +1,90 @@
+#pragma once
+#include <gamekid/utils/types.h>
+#include <cstdint>
+
+namespace gamekid::state {
+    class snapshot;
+}
+
+namespace gamekid::io {
+
+    // What one end puts on the link at a synchronization point
+    struct link_state {
+        // the cycle of the synchronization point
+        std::uint64_t cycle;
+        // an internal clock transfer waiting for the link started in this cycle (or serial::never)
+        std::uint64_t transfer_start;
+        // SB
+        byte data;
+        // waiting for a transfer with the external clock
+        bool armed;
+        // a transfer was requested and did not complete yet
+        bool active;
+    };
+
+    // The serial port (SB and SC).
+    // Without a link a transfer with the internal clock shifts in 0xFF after transfer_cycles.
+    // When it is linked, the bits are shifted by the link (a link_cable) which completes
+    // the transfers of both ends at its own synchronization points.
+    class serial {
+    private:
+        std::uint64_t _cycle = 0;
+        byte _sb = 0;
+        byte _sc = 0;
+        bool _linked = false;
+        // an internal clock transfer that started in this cycle is waiting for the link
+        std::uint64_t _transfer_start;
+        // the transfer completes in this cycle and SB becomes _received
+        std::uint64_t _completion;
+        byte _received = 0xFF;
+    public:
+        static constexpr std::uint64_t never = UINT64_MAX;
+        // 8 bits at 8192hz
+        static constexpr dword transfer_cycles = 4096;
+
+        serial();
+
+        byte load(word address) const;
+        void store(word address, byte value);
+
+        // Advances the serial clock, returns true if a transfer completed (the serial interrupt)
+        bool tick(dword cycles);
+
+        void save(state::snapshot& snapshot) const;
+        void load(state::snapshot& snapshot);
+
+        std::uint64_t cycle() const {
+            return _cycle;
+        }
+
+        std::uint64_t completion() const {
+            return _completion;
+        }
+
+        bool linked() const;
+        void linked(bool value);
+
+        // The cycle in which an internal clock transfer waiting for the link started, or never
+        std::uint64_t transfer_start() const;
+
+        // SC requests a transfer with the external clock, it waits for the other end
+        bool armed() const;
+
+        // A transfer was requested and did not complete yet
+        bool active() const;
+
+        // The byte which is shifted out
+        byte data() const;
+
+        // The link shifted the bits, SB becomes the value in the given cycle
+        void complete(byte value, std::uint64_t cycle);
+
+        // The state of this end at a synchronization point (its current cycle)
+        link_state state() const;
+
+        // Shifts the bits of a transfer waiting for the link with the other end, which
+        // was at the same synchronization point. A transfer completes at the synchronization
+        // point, but not before the serial clock of the master shifted all the bits
+        void link(const link_state& other);
+    };
+}
@@ -0,0 +1,13 @@
+#include "serial_register_cell.h"
+
+gamekid::io::serial_register_cell::serial_register_cell(serial& serial, word address) :
+_serial(serial), _address(address) {
+}
+
+byte gamekid::io::serial_register_cell::load() {
+    return _serial.load(_address);
+}
+
+void gamekid::io::serial_register_cell::store(byte value) {
+    _serial.store(_address, value);
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "serial.h"
+#include "gamekid/memory/cell.h"
+
+namespace gamekid::io {
+    // SB or SC, which are kept in the serial port
+    class serial_register_cell : public memory::cell {
+    private:
+        serial& _serial;
+        word _address;
+    public:
+        serial_register_cell(serial& serial, word address);
+        byte load() override;
+        void store(byte value) override;
+    };
+}
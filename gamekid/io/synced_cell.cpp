@@ -0,0 +1,18 @@
+#include "synced_cell.h"
+
+gamekid::io::synced_cell::synced_cell(memory::cell& cell, catch_up& sync) :
+_cell(cell), _sync(sync) {
+}
+
+byte gamekid::io::synced_cell::load() {
+    _sync.sync();
+    return _cell.load();
+}
+
+void gamekid::io::synced_cell::store(byte value) {
+    _sync.sync();
+    _cell.store(value);
+
+    // the store may move the next event (turning the lcd on, writing TAC)
+    _sync.reschedule();
+}
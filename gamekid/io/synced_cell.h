@@ -0,0 +1,17 @@
+#pragma once
+#include "catch_up.h"
+#include "gamekid/memory/cell.h"
+
+namespace gamekid::io {
+    // A register of a component which runs behind the cpu,
+    // the component is caught up before the register is accessed
+    class synced_cell : public memory::cell {
+    private:
+        memory::cell& _cell;
+        catch_up& _sync;
+    public:
+        synced_cell(memory::cell& cell, catch_up& sync);
+        byte load() override;
+        void store(byte value) override;
+    };
+}
@@ -0,0 +1,136 @@
+#include "timer.h"
+#include "io_registers.h"
+#include <gamekid/state/snapshot.h>
+
+using gamekid::io::timer;
+
+namespace {
+    const byte tac_enable = 0b100;
+    // the falling edges of counter bits 9, 3, 5 and 7
+    const std::uint64_t tac_periods[] = { 1024, 16, 64, 256 };
+}
+
+timer::timer() : _next_overflow(never) {
+}
+
+bool timer::enabled() const {
+    return (_tac & tac_enable) != 0;
+}
+
+std::uint64_t timer::period() const {
+    return tac_periods[_tac & 0b11];
+}
+
+bool timer::counter_bit() const {
+    // the bit is set in the second half of every period
+    const std::uint64_t counter = _cycle - _div_reset;
+    return enabled() && (counter & (period() >> 1)) != 0;
+}
+
+void timer::catch_up() {
+    if (enabled()) {
+        // the edges are crossings of multiples of the period, the 16 bit counter wraps on one too
+        std::uint64_t edges = (_cycle - _div_reset) / period() - (_tima_cycle - _div_reset) / period();
+        const dword until_overflow = 0x100 - _tima;
+
+        if (edges < until_overflow) {
+            _tima = static_cast<byte>(_tima + edges);
+        } else {
+            // TIMA was reloaded from TMA and counted up from it again
+            edges -= until_overflow;
+            _tima = static_cast<byte>(_tma + edges % (0x100 - _tma));
+        }
+    }
+
+    _tima_cycle = _cycle;
+}
+
+bool timer::increment() {
+    if (_tima == 0xFF) {
+        _tima = _tma;
+        return true;
+    }
+
+    ++_tima;
+    return false;
+}
+
+void timer::schedule() {
+    if (!enabled()) {
+        _next_overflow = never;
+        return;
+    }
+
+    // the edge that takes TIMA from 0xFF to 0
+    const std::uint64_t edge = (_tima_cycle - _div_reset) / period() + (0x100 - _tima);
+    _next_overflow = _div_reset + edge * period();
+}
+
+byte timer::load(word address) {
+    switch (address) {
+    case DIV:
+        return static_cast<byte>((_cycle - _div_reset) >> 8);
+    case TIMA:
+        catch_up();
+        return _tima;
+    case TMA:
+        return _tma;
+    default:
+        // the unused bits of TAC read as 1
+        return _tac | 0xF8;
+    }
+}
+
+void timer::store(word address, byte value) {
+    catch_up();
+    // an overflow is only due in this cycle if an earlier write caused it
+    bool overflow = _next_overflow == _cycle;
+    const bool old_bit = counter_bit();
+
+    switch (address) {
+    case DIV:
+        _div_reset = _cycle;
+        break;
+    case TIMA:
+        _tima = value;
+        break;
+    case TMA:
+        _tma = value;
+        break;
+    default:
+        _tac = value & 0b111;
+        break;
+    }
+
+    // the counter bit is anded with the enable bit before the edge detector,
+    // so resetting DIV or changing TAC can make it fall and increment TIMA
+    if (old_bit && !counter_bit()) {
+        overflow = increment() || overflow;
+    }
+
+    schedule();
+
+    if (overflow) {
+        _next_overflow = _cycle;
+    }
+}
+
+bool timer::tick(dword cycles) {
+    _cycle += cycles;
+
+    if (_cycle < _next_overflow) {
+        return false;
+    }
+
+    catch_up();
+    schedule();
+    return true;
+}
+
+void timer::save(state::snapshot& snapshot) const {
+    snapshot.write(_cycle, _div_reset, _tima, _tima_cycle, _tma, _tac, _next_overflow);
+}
+
+void timer::load(state::snapshot& snapshot) {
+    snapshot.read(_cycle, _div_reset, _tima, _tima_cycle, _tma, _tac, _next_overflow);
+}
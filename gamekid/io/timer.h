@@ -0,0 +1,58 @@
+#pragma once
+#include <gamekid/utils/types.h>
+#include <cstdint>
+
+namespace gamekid::state {
+    class snapshot;
+}
+
+namespace gamekid::io {
+
+    // The divider and the timer (DIV, TIMA, TMA and TAC).
+    // Nothing is counted per cycle: DIV is the cycles since it was last reset and TIMA
+    // is its value at the last write plus the falling edges of the selected counter bit since.
+    // The next TIMA overflow is kept as a single event cycle, recomputed on every register write.
+    class timer {
+    private:
+        std::uint64_t _cycle = 0;
+        // the cycle in which DIV was reset, the internal 16 bit counter is _cycle - _div_reset
+        std::uint64_t _div_reset = 0;
+        // TIMA was _tima in _tima_cycle
+        byte _tima = 0;
+        std::uint64_t _tima_cycle = 0;
+        byte _tma = 0;
+        byte _tac = 0;
+        std::uint64_t _next_overflow;
+
+        bool enabled() const;
+        // the period of the selected counter bit, TIMA counts its falling edges
+        std::uint64_t period() const;
+        bool counter_bit() const;
+        // brings _tima to the current cycle
+        void catch_up();
+        // an increment caused by a falling edge out of a write (DIV reset or TAC change),
+        // returns true if TIMA overflowed
+        bool increment();
+        void schedule();
+    public:
+        static constexpr std::uint64_t never = UINT64_MAX;
+
+        timer();
+        byte load(word address);
+        void store(word address, byte value);
+
+        // Advances the master cycle count, returns true if TIMA overflowed (the timer interrupt)
+        bool tick(dword cycles);
+
+        void save(state::snapshot& snapshot) const;
+        void load(state::snapshot& snapshot);
+
+        std::uint64_t cycle() const {
+            return _cycle;
+        }
+
+        std::uint64_t next_overflow() const {
+            return _next_overflow;
+        }
+    };
+}
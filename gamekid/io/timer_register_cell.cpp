@@ -0,0 +1,13 @@
+#include "timer_register_cell.h"
+
+gamekid::io::timer_register_cell::timer_register_cell(timer& timer, word address) :
+_timer(timer), _address(address) {
+}
+
+byte gamekid::io::timer_register_cell::load() {
+    return _timer.load(_address);
+}
+
+void gamekid::io::timer_register_cell::store(byte value) {
+    _timer.store(_address, value);
+}
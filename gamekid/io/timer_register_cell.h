@@ -0,0 +1,16 @@
+#pragma once
+#include "timer.h"
+#include "gamekid/memory/cell.h"
+
+namespace gamekid::io {
+    // DIV, TIMA, TMA or TAC, which are kept in the timer
+    class timer_register_cell : public memory::cell {
+    private:
+        timer& _timer;
+        word _address;
+    public:
+        timer_register_cell(timer& timer, word address);
+        byte load() override;
+        void store(byte value) override;
+    };
+}
@@ -0,0 +1,129 @@
+#include "deferred_renderer.h"
+#include "lcd_timing.h"
+
+using namespace gamekid::io::video;
+
+deferred_renderer::deferred_renderer(const video_state& initial_state, renderer_type type, bool async) :
+_state(initial_state), _renderer(renderer::create(type)), _async(async) {
+    if (_async) {
+        _worker = std::thread(&deferred_renderer::work, this);
+    }
+}
+
+deferred_renderer::~deferred_renderer() {
+    if (_async) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+
+        _condition.notify_all();
+        _worker.join();
+    }
+}
+
+void deferred_renderer::replay(const std::vector<video_write>& writes, bool render) {
+    dword cycle = 0;
+    frame& target = _frames[(_drawn_renders + 1) % _frames.size()];
+
+    if (render) {
+        _renderer->begin_frame();
+    }
+
+    for (const video_write& write : writes) {
+        if (render && write.cycle > cycle) {
+            _renderer->render(_state, cycle, write.cycle, target);
+            cycle = write.cycle;
+        }
+
+        _state.store(write.address, write.value);
+    }
+
+    if (render) {
+        _renderer->render(_state, cycle, lcd_timing::vblank_start, target);
+        ++_drawn_renders;
+    }
+}
+
+void deferred_renderer::submit(std::vector<video_write>& writes, bool render) {
+    if (render) {
+        ++_submitted_renders;
+    }
+
+    if (!_async) {
+        replay(writes, render);
+        writes.clear();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // the worker may still replay the previous batch, only the queued one has to be taken
+    _condition.wait(lock, [this] { return !_has_queued; });
+
+    _queued.swap(writes);
+    writes.clear();
+    _render_queued = render;
+    _has_queued = true;
+    lock.unlock();
+
+    _condition.notify_all();
+}
+
+void deferred_renderer::work() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (true) {
+        _condition.wait(lock, [this] { return _has_queued || _stop; });
+
+        if (_stop) {
+            return;
+        }
+
+        // the cpu thread queues the next batch while this one is replayed
+        _working.swap(_queued);
+        const bool render = _render_queued;
+        _has_queued = false;
+        _busy = true;
+        _condition.notify_all();
+
+        lock.unlock();
+        replay(_working, render);
+        _working.clear();
+        lock.lock();
+
+        _busy = false;
+        _completed_renders = _drawn_renders;
+        _condition.notify_all();
+    }
+}
+
+void deferred_renderer::wait() {
+    if (_async) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this] { return !_has_queued && !_busy; });
+    }
+}
+
+const frame& deferred_renderer::screen() {
+    wait();
+    return _frames[_submitted_renders % _frames.size()];
+}
+
+const frame& deferred_renderer::previous_screen() {
+    if (_submitted_renders == 0) {
+        return _frames[0];
+    }
+
+    if (_async) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this] { return _completed_renders + 1 >= _submitted_renders; });
+    }
+
+    return _frames[(_submitted_renders - 1) % _frames.size()];
+}
+
+void deferred_renderer::restart(const video_state& state) {
+    wait();
+    _state = state;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "frame.h"
+#include "video_state.h"
+#include "renderer.h"
+#include <array>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace gamekid::io::video {
+    // Renders a whole frame at vblank by replaying the writes that were made during the frame.
+    // The renderer is run between the writes, so every line (or dot) sees exactly the writes 
+    // that happened before it and the result is the same as drawing while the cpu runs.
+    class deferred_renderer {
+    private:
+        video_state _state;
+        std::unique_ptr<renderer> _renderer;
+        // the frame of render k is _frames[k % 3]: while the worker draws the last submitted frame,
+        // the one before it is shown and the next one can be submitted
+        std::array<frame, 3> _frames{};
+        // only used by the cpu thread, and by the worker for the frames it draws
+        dword _submitted_renders = 0;
+        dword _drawn_renders = 0;
+
+        // async mode - the frame is rendered on a worker thread while the cpu runs the next frame.
+        // The writes are double buffered: a batch is queued while the worker replays the previous one
+        bool _async;
+        std::thread _worker;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::vector<video_write> _queued;
+        std::vector<video_write> _working;
+        bool _has_queued = false;
+        bool _render_queued = false;
+        bool _busy = false;
+        dword _completed_renders = 0;
+        bool _stop = false;
+
+        void replay(const std::vector<video_write>& writes, bool render);
+        void work();
+    public:
+        deferred_renderer(const video_state& initial_state, renderer_type type, bool async);
+        ~deferred_renderer();
+
+        deferred_renderer(const deferred_renderer&) = delete;
+        deferred_renderer& operator=(const deferred_renderer&) = delete;
+
+        // Takes the writes of the frame, the given vector is left empty (with its capacity) for the next frame.
+        // When render is false the writes are only applied (the frame was not completed).
+        // It only waits when the worker is still replaying a batch and another one is queued
+        void submit(std::vector<video_write>& writes, bool render);
+
+        // Waits until all the submitted frames were rendered
+        void wait();
+
+        // The last submitted frame, once it is drawn
+        const frame& screen();
+
+        // The frame before the last submitted one, which the worker drew while the cpu ran the last one.
+        // It only waits for that frame
+        const frame& previous_screen();
+
+        // Starts again from the given video state, the writes that were submitted and not drawn are dropped
+        void restart(const video_state& state);
+    };
+}
@@ -0,0 +1,288 @@
+#include "fifo_renderer.h"
+#include "lcd_timing.h"
+#include "tile_data.h"
+#include <gamekid/utils/bits.h>
+#include <algorithm>
+
+using namespace gamekid::io::video;
+using namespace gamekid::io::video::tile_data;
+using gamekid::utils::bits::check_bit;
+
+namespace {
+    // the first fetch of every line is thrown away
+    const byte startup_cycles = 6;
+    const byte fetch_step_cycles = 2;
+    const byte sprite_fetch_cycles = 6;
+}
+
+void fifo_renderer::begin_frame() {
+    _window_line = 0;
+    _drawing = false;
+}
+
+dword fifo_renderer::pixel_transfer_cycles() const {
+    return _transfer_cycles;
+}
+
+void fifo_renderer::render(const video_state& state, dword from_cycle, dword to_cycle, frame& target) {
+    dword cycle = from_cycle;
+
+    while (cycle < to_cycle) {
+        const dword line = cycle / lcd_timing::cycles_per_line;
+
+        // nothing is drawn in vblank
+        if (line >= lcd_timing::visible_lines) {
+            return;
+        }
+
+        const dword line_start = line * lcd_timing::cycles_per_line;
+        const dword transfer_start = line_start + lcd_timing::oam_search_cycles;
+
+        if (cycle < transfer_start) {
+            cycle = std::min(to_cycle, transfer_start);
+            continue;
+        }
+
+        if (cycle == transfer_start) {
+            start_line(state, static_cast<byte>(line));
+        }
+
+        // hblank
+        if (!_drawing) {
+            cycle = std::min(to_cycle, line_start + lcd_timing::cycles_per_line);
+            continue;
+        }
+
+        dot(state, target, cycle);
+        ++cycle;
+    }
+}
+
+void fifo_renderer::start_line(const video_state& state, byte line) {
+    const byte lcdc = state.reg(LCDC);
+
+    _line = line;
+    _drawing = true;
+    _transfer_start = lcd_timing::line_render_cycle(line);
+    _transfer_cycles = unknown_cycles;
+    _x = 0;
+    _discard = state.reg(SCX) % 8;
+
+    _step = fetch_step::tile;
+    _step_dots = 0;
+    _fetcher_x = 0;
+    _startup_dots = startup_cycles;
+    _window = false;
+    _bg_head = 0;
+    _bg_count = 0;
+
+    _sprite_fifo.fill(sprite_pixel{ 0, false, false });
+    _sprite_fetch_dots = 0;
+    _next_sprite = 0;
+    _sprites_count = 0;
+
+    if (!check_bit(lcdc, lcd_control_bits::sprite_display_enable)) {
+        return;
+    }
+
+    // OAM search - the first 10 sprites (in oam order) that are on this line
+    const byte height = check_bit(lcdc, lcd_control_bits::sprite_size) ? 16 : 8;
+
+    for (byte i = 0; i < oam_size / 4 && _sprites_count < sprites_per_line; ++i) {
+        const int sprite_y = state.oam[i * 4] - 16;
+
+        if (line >= sprite_y && line < sprite_y + height) {
+            _sprites[_sprites_count++] = i;
+        }
+    }
+
+    // the sprites are fetched from left to right, on a tie the first in the oam is fetched first
+    std::stable_sort(_sprites.begin(), _sprites.begin() + _sprites_count, [&](byte a, byte b) {
+        return state.oam[a * 4 + 1] < state.oam[b * 4 + 1];
+    });
+}
+
+bool fifo_renderer::window_starts(const video_state& state) const {
+    const byte lcdc = state.reg(LCDC);
+    const int window_x = state.reg(WX) - 7;
+
+    return !_window &&
+        check_bit(lcdc, lcd_control_bits::bg_display) &&
+        check_bit(lcdc, lcd_control_bits::window_display_enable) &&
+        _line >= state.reg(WY) &&
+        window_x < screen_width &&
+        _x == std::max(window_x, 0);
+}
+
+bool fifo_renderer::sprite_starts(const video_state& state) const {
+    if (_next_sprite >= _sprites_count) {
+        return false;
+    }
+
+    const int sprite_x = state.oam[_sprites[_next_sprite] * 4 + 1] - 8;
+    return sprite_x <= _x;
+}
+
+void fifo_renderer::dot(const video_state& state, frame& target, dword cycle) {
+    if (_startup_dots > 0) {
+        --_startup_dots;
+        return;
+    }
+
+    // the fifo is stopped while a sprite is fetched
+    if (_sprite_fetch_dots == 0 && sprite_starts(state)) {
+        _sprite_fetch_dots = sprite_fetch_cycles;
+    }
+
+    if (_sprite_fetch_dots > 0) {
+        if (--_sprite_fetch_dots == 0) {
+            fetch_sprite(state, state.oam.data() + _sprites[_next_sprite++] * 4);
+        }
+
+        return;
+    }
+
+    // the window restarts the fetcher with an empty fifo
+    if (window_starts(state)) {
+        const int window_x = state.reg(WX) - 7;
+
+        _window = true;
+        _bg_head = 0;
+        _bg_count = 0;
+        _step = fetch_step::tile;
+        _step_dots = 0;
+        _fetcher_x = 0;
+        _discard = window_x < 0 ? static_cast<byte>(-window_x) : 0;
+    }
+
+    step_fetcher(state);
+    output_pixel(state, target, cycle);
+}
+
+void fifo_renderer::step_fetcher(const video_state& state) {
+    const byte lcdc = state.reg(LCDC);
+
+    if (_step != fetch_step::push && ++_step_dots < fetch_step_cycles) {
+        return;
+    }
+
+    _step_dots = 0;
+
+    switch (_step) {
+    case fetch_step::tile: {
+        word map;
+        byte map_x;
+        byte y;
+
+        if (_window) {
+            map = check_bit(lcdc, lcd_control_bits::window_tile_map_display_select) ? tile_map_high : tile_map_low;
+            map_x = _fetcher_x & 31;
+            y = _window_line;
+        } else {
+            map = check_bit(lcdc, lcd_control_bits::bg_tile_map_display_select) ? tile_map_high : tile_map_low;
+            map_x = ((state.reg(SCX) / 8) + _fetcher_x) & 31;
+            y = static_cast<byte>(state.reg(SCY) + _line);
+        }
+
+        const byte tile_index = state.vram[map + (y / 8) * 32 + map_x];
+        _row_address = bg_tile_row(lcdc, tile_index, y % 8);
+        _step = fetch_step::data_low;
+        break;
+    }
+    case fetch_step::data_low:
+        _data_low = state.vram[_row_address];
+        _step = fetch_step::data_high;
+        break;
+    case fetch_step::data_high:
+        _data_high = state.vram[_row_address + 1];
+        _step = fetch_step::push;
+        break;
+    case fetch_step::push:
+        // the fetcher waits until the fifo is empty
+        if (_bg_count == 0) {
+            push_pixels();
+            ++_fetcher_x;
+            _step = fetch_step::tile;
+        }
+        break;
+    }
+}
+
+void fifo_renderer::push_pixels() {
+    const byte row[] = { _data_low, _data_high };
+
+    for (byte x = 0; x < 8; ++x) {
+        _bg_fifo[x] = row_color(row, x);
+    }
+
+    _bg_head = 0;
+    _bg_count = 8;
+}
+
+void fifo_renderer::output_pixel(const video_state& state, frame& target, dword cycle) {
+    if (_bg_count == 0) {
+        return;
+    }
+
+    const byte bg_color = _bg_fifo[_bg_head++];
+    --_bg_count;
+
+    // the fine scroll pixels are thrown away
+    if (_discard > 0) {
+        --_discard;
+        return;
+    }
+
+    const sprite_pixel sprite = _sprite_fifo[0];
+    std::copy(_sprite_fifo.begin() + 1, _sprite_fifo.end(), _sprite_fifo.begin());
+    _sprite_fifo.back() = sprite_pixel{ 0, false, false };
+
+    const byte lcdc = state.reg(LCDC);
+    const bool bg_enabled = check_bit(lcdc, lcd_control_bits::bg_display);
+    const byte color = bg_enabled ? bg_color : 0;
+    byte shade = bg_enabled ? apply_pallete(state.reg(BGP), bg_color) : 0;
+
+    if (check_bit(lcdc, lcd_control_bits::sprite_display_enable) && 
+        sprite.color != 0 && (!sprite.behind_bg || color == 0)) {
+        shade = apply_pallete(state.reg(sprite.obp1 ? OBP1 : OBP0), sprite.color);
+    }
+
+    target[_line * screen_width + _x] = shade;
+    ++_x;
+
+    if (_x == screen_width) {
+        _drawing = false;
+        _transfer_cycles = cycle - _transfer_start + 1;
+
+        if (_window) {
+            ++_window_line;
+        }
+    }
+}
+
+void fifo_renderer::fetch_sprite(const video_state& state, const byte* sprite) {
+    const byte lcdc = state.reg(LCDC);
+    const byte height = check_bit(lcdc, lcd_control_bits::sprite_size) ? 16 : 8;
+    const byte flags = sprite[3];
+    const int sprite_x = sprite[1] - 8;
+
+    byte row_index = static_cast<byte>(_line - (sprite[0] - 16));
+    if (check_bit(flags, 6)) row_index = height - 1 - row_index;
+
+    const byte tile_index = height == 16 ? (sprite[2] & 0xFE) : sprite[2];
+    const byte* row = state.vram.data() + tile_index * 16 + row_index * 2;
+
+    for (byte x = 0; x < 8; ++x) {
+        const int slot = sprite_x + x - _x;
+
+        // the sprite pixels left of the screen are not drawn
+        if (slot < 0) continue;
+
+        const byte color = row_color(row, check_bit(flags, 5) ? 7 - x : x);
+
+        // a sprite which was fetched before keeps its opaque pixels
+        if (color == 0 || _sprite_fifo[slot].color != 0) continue;
+
+        _sprite_fifo[slot] = sprite_pixel{ color, check_bit(flags, 4), check_bit(flags, 7) };
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "renderer.h"
+
+namespace gamekid::io::video {
+    // Dot accurate ppu - a background fetcher feeds a pixel fifo which is shifted out one pixel per dot.
+    // The registers are read when the fetcher reads them, so mid-line writes (SCX, BGP...) take effect
+    // in the middle of the line, and the pixel transfer gets longer with fine scroll, window and sprites.
+    class fifo_renderer : public renderer {
+    private:
+        struct sprite_pixel {
+            byte color;
+            bool obp1;
+            bool behind_bg;
+        };
+
+        enum class fetch_step { tile, data_low, data_high, push };
+
+        static const dword unknown_cycles = 0xFFFFFFFF;
+
+        // line state
+        byte _line = 0;
+        bool _drawing = false;
+        dword _transfer_start = 0;
+        dword _transfer_cycles = unknown_cycles;
+        int _x = 0;
+        byte _discard = 0;
+
+        // background / window fetcher
+        fetch_step _step = fetch_step::tile;
+        byte _step_dots = 0;
+        byte _fetcher_x = 0;
+        word _row_address = 0;
+        byte _data_low = 0;
+        byte _data_high = 0;
+        byte _startup_dots = 0;
+        bool _window = false;
+        byte _window_line = 0;
+
+        std::array<byte, 8> _bg_fifo{};
+        byte _bg_head = 0;
+        byte _bg_count = 0;
+
+        // sprites of the line, ordered by the fetch order
+        std::array<byte, 10> _sprites{};
+        byte _sprites_count = 0;
+        byte _next_sprite = 0;
+        byte _sprite_fetch_dots = 0;
+        std::array<sprite_pixel, 8> _sprite_fifo{};
+
+        void start_line(const video_state& state, byte line);
+        void dot(const video_state& state, frame& target, dword cycle);
+        void push_pixels();
+        void output_pixel(const video_state& state, frame& target, dword cycle);
+        void step_fetcher(const video_state& state);
+        void fetch_sprite(const video_state& state, const byte* sprite);
+        bool window_starts(const video_state& state) const;
+        bool sprite_starts(const video_state& state) const;
+    public:
+        void begin_frame() override;
+        void render(const video_state& state, dword from_cycle, dword to_cycle, frame& target) override;
+        dword pixel_transfer_cycles() const override;
+    };
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include <gamekid/utils/types.h>
+#include <array>
+
+namespace gamekid::io::video {
+    const int screen_width = 160;
+    const int screen_height = 144;
+
+    // every pixel is a shade index (0 to 3) after the pallete was applied
+    using frame = std::array<byte, screen_width * screen_height>;
+}
@@ -1,11 +1,49 @@
 #include "lcd.h"
+#include "lcd_timing.h"
+#include "fifo_renderer.h"
+#include "scanline_renderer.h"
+#include <gamekid/state/snapshot.h>
+#include <algorithm>
+
+using gamekid::io::video::lcd;
+using gamekid::io::video::render_mode;
+
+namespace {
+    const size_t off_log_limit = 0x1000;
+
+    // the bytes of the state's and the log's blocks which no other lcd refers to
+    template <size_t Size>
+    size_t unshared_size(const gamekid::io::video::shared_bytes<Size>& state, const gamekid::io::video::shared_bytes<Size>& log) {
+        if (state.shares(log)) {
+            return state.copies() == 2 ? Size : 0;
+        }
+
+        return (state.copies() == 1 ? Size : 0) + (log.copies() == 1 ? Size : 0);
+    }
+}
+
+lcd::lcd(render_mode mode, renderer_type type) :
+_mode(mode), _requested_mode(mode), _renderer_type(type), _requested_renderer_type(type),
+_renderer(renderer::create(type)) {
+    if (is_deferred()) {
+        _deferred = std::make_unique<deferred_renderer>(_state, _renderer_type, _mode == render_mode::deferred_async);
+    }
+}
 
 bool gamekid::io::video:: lcd::enabled() const {
     return _enabled;
 }
 
 void gamekid::io::video::lcd::enabled(bool value) {
+    if (_enabled == value) {
+        return;
+    }
+
     _enabled = value;
+
+    // the frame that was drawn is dropped and a new one starts when the lcd is turned on
+    _cycle = 0;
+    begin_frame();
 }
 
 bool gamekid::io::video::lcd::window_enabled() const {
@@ -15,3 +53,245 @@ bool gamekid::io::video::lcd::window_enabled() const {
 void gamekid::io::video::lcd::window_enabled(bool value) {
     _window_enabled = value;
 }
+
+render_mode lcd::mode() const {
+    return _mode;
+}
+
+void lcd::mode(render_mode value) {
+    _requested_mode = value;
+}
+
+gamekid::io::video::renderer_type lcd::backend() const {
+    return _renderer_type;
+}
+
+void lcd::backend(renderer_type value) {
+    _requested_renderer_type = value;
+}
+
+bool lcd::is_deferred() const {
+    return _mode != render_mode::scanline;
+}
+
+byte lcd::load(word address) const {
+    switch (address) {
+    case LY:
+        return ly();
+    case STAT: {
+        const dword line_cycle = _cycle % lcd_timing::cycles_per_line;
+        byte mode = 0;
+
+        // the live renderer knows the length of the current pixel transfer, it runs in the deferred modes too
+        const dword pixel_transfer_cycles = _renderer->pixel_transfer_cycles();
+
+        if (_enabled) {
+            if (ly() >= lcd_timing::visible_lines) mode = 1;
+            else if (line_cycle < lcd_timing::oam_search_cycles) mode = 2;
+            else if (line_cycle - lcd_timing::oam_search_cycles < pixel_transfer_cycles) mode = 3;
+        }
+
+        const byte coincidence = (ly() == _state.reg(LYC)) ? 0b100 : 0;
+        return 0x80 | (_state.reg(STAT) & 0x78) | coincidence | mode;
+    }
+    default:
+        return _state.load(address);
+    }
+}
+
+void lcd::store(word address, byte value) {
+    // LY is read only
+    if (address == LY) {
+        return;
+    }
+
+    _state.store(address, value);
+    _writes.push_back(video_write{ _cycle, address, value });
+
+    // no frame starts while the lcd is off, the log is applied and started again before it grows too long
+    if (!_enabled && _writes.size() >= off_log_limit) {
+        begin_frame();
+    }
+}
+
+void lcd::begin_frame() {
+    if (is_deferred()) {
+        // apply the writes made after vblank (or in an unfinished frame) without drawing
+        _deferred->submit(_writes, false);
+    }
+
+    if (_requested_mode != _mode || _requested_renderer_type != _renderer_type) {
+        if (is_deferred()) {
+            _frame = _deferred->screen();
+        }
+
+        _mode = _requested_mode;
+        _renderer_type = _requested_renderer_type;
+        create_renderers();
+    }
+
+    _renderer->begin_frame();
+    restart_log(0);
+}
+
+void lcd::restart_log(dword cycle) {
+    _log_state = _state;
+    _log_cycle = cycle;
+    _writes.clear();
+}
+
+void lcd::create_renderers() {
+    _renderer = renderer::create(_renderer_type);
+    _deferred.reset();
+
+    if (is_deferred()) {
+        _deferred = std::make_unique<deferred_renderer>(_state, _renderer_type, _mode == render_mode::deferred_async);
+    }
+}
+
+void lcd::tick(dword cycles) {
+    if (!_enabled) {
+        return;
+    }
+
+    const dword from_cycle = _cycle;
+    const dword to_cycle = _cycle + cycles;
+
+    const bool render = renders_live();
+
+    if (render) {
+        _renderer->render(_state, from_cycle, std::min(to_cycle, lcd_timing::cycles_per_frame), _frame);
+    }
+
+    if (from_cycle < lcd_timing::vblank_start && to_cycle >= lcd_timing::vblank_start) {
+        if (is_deferred()) {
+            _deferred->submit(_writes, _draw);
+        }
+
+        restart_log(lcd_timing::vblank_start);
+    }
+
+    _cycle = to_cycle;
+
+    if (_cycle >= lcd_timing::cycles_per_frame) {
+        _cycle -= lcd_timing::cycles_per_frame;
+        ++_frame_count;
+        begin_frame();
+
+        if (render) {
+            _renderer->render(_state, 0, _cycle, _frame);
+        }
+    }
+}
+
+bool lcd::renders_live() const {
+    // the line renderer doesn't change the timing, it can be skipped. In the deferred modes the live
+    // pixel fifo only runs for the length of mode 3, the screen is drawn from the log
+    if (is_deferred()) {
+        return _renderer_type != renderer_type::per_line;
+    }
+
+    return _draw || _renderer_type != renderer_type::per_line;
+}
+
+byte lcd::ly() const {
+    if (!_enabled) {
+        return 0;
+    }
+
+    return static_cast<byte>(_cycle / lcd_timing::cycles_per_line);
+}
+
+dword lcd::frame_count() const {
+    return _frame_count;
+}
+
+dword lcd::cycles_to_frame_end() const {
+    return lcd_timing::cycles_per_frame - _cycle;
+}
+
+const gamekid::io::video::frame& lcd::screen() {
+    if (_mode == render_mode::deferred_async) {
+        return _deferred->previous_screen();
+    }
+
+    if (is_deferred()) {
+        return _deferred->screen();
+    }
+
+    return _frame;
+}
+
+bool lcd::draw() const {
+    return _draw;
+}
+
+void lcd::draw(bool value) {
+    _draw = value;
+}
+
+void lcd::save(state::snapshot& snapshot) {
+    snapshot.write(_enabled, _window_enabled, _cycle, _frame_count, _log_cycle);
+    _log_state.save(snapshot);
+    snapshot.write_vector(_writes, [](state::snapshot& image, const video_write& write) {
+        image.write(write.cycle, write.address, write.value);
+    });
+}
+
+void lcd::load(state::snapshot& snapshot) {
+    snapshot.read(_enabled, _window_enabled, _cycle, _frame_count, _log_cycle);
+    state::snapshot::check_below(_cycle, lcd_timing::cycles_per_frame);
+    state::snapshot::check_below(_log_cycle, _cycle + 1);
+    _log_state.load(snapshot);
+
+    snapshot.read_vector(_writes, [this](state::snapshot& image, video_write& write) {
+        image.read(write.cycle, write.address, write.value);
+        state::snapshot::check_below(write.cycle, _cycle + 1);
+    });
+
+    // the backend is brought to the saved cycle by drawing the log again
+    _state = _log_state;
+    _renderer->begin_frame();
+
+    if (is_deferred()) {
+        _deferred->restart(_log_state);
+    }
+
+    const bool render = _enabled && renders_live();
+    dword cycle = _log_cycle;
+
+    for (const video_write& write : _writes) {
+        if (render && write.cycle > cycle) {
+            _renderer->render(_state, cycle, write.cycle, _frame);
+            cycle = write.cycle;
+        }
+
+        _state.store(write.address, write.value);
+    }
+
+    if (render && _cycle > cycle) {
+        _renderer->render(_state, cycle, _cycle, _frame);
+    }
+}
+
+void lcd::share(const lcd& other) {
+    _state = other._state;
+    _log_state = other._log_state;
+}
+
+size_t lcd::heap_size() const {
+    const size_t renderer_size = _renderer_type == renderer_type::pixel_fifo ? sizeof(fifo_renderer) : sizeof(scanline_renderer);
+    size_t size = _writes.capacity() * sizeof(video_write);
+
+    if (_renderer) {
+        size += renderer_size;
+    }
+
+    // the deferred renderer has a renderer, a state and a frame of its own
+    if (_deferred) {
+        size += sizeof(deferred_renderer) + renderer_size;
+    }
+
+    size += unshared_size(_state.vram, _log_state.vram) + unshared_size(_state.oam, _log_state.oam);
+    return size;
+}
@@ -1,18 +1,111 @@
 #pragma once
+#include "frame.h"
+#include "video_state.h"
+#include "renderer.h"
+#include "deferred_renderer.h"
+#include <memory>
+#include <vector>
+
+namespace gamekid::state {
+    class snapshot;
+}
 
 namespace gamekid::io::video {
+    enum class render_mode {
+        // every line is drawn while the cpu runs, when its pixel transfer starts
+        scanline,
+        // the writes to the video state are logged and the frame is drawn at vblank
+        deferred,
+        // like deferred, the frame is drawn on a worker thread while the cpu runs the next frame,
+        // so the screen is a frame behind
+        deferred_async
+    };
+
     class lcd;
 
     class lcd {
     private:
         bool _enabled = false;
         bool _window_enabled = false;
+
+        render_mode _mode;
+        render_mode _requested_mode;
+        renderer_type _renderer_type;
+        renderer_type _requested_renderer_type;
+        video_state _state;
+        dword _cycle = 0;
+        dword _frame_count = 0;
+        bool _draw = true;
+
+        // scanline mode
+        std::unique_ptr<renderer> _renderer;
+        frame _frame{};
+
+        // deferred modes
+        std::unique_ptr<deferred_renderer> _deferred;
+
+        // The writes since the start of the frame or since vblank, and the video state they were made on.
+        // The deferred modes draw the frame from them, a loaded state is drawn again from them up to its cycle
+        video_state _log_state;
+        dword _log_cycle = 0;
+        std::vector<video_write> _writes;
+
+        void begin_frame();
+        void restart_log(dword cycle);
+        void create_renderers();
+        bool is_deferred() const;
+        // the live renderer runs while the cpu runs
+        bool renders_live() const;
     public:
+        explicit lcd(render_mode mode = render_mode::scanline, renderer_type type = renderer_type::per_line);
+
+        lcd(const lcd&) = delete;
+        lcd& operator=(const lcd&) = delete;
+
         bool enabled() const;
         void enabled(bool value);
 
         bool window_enabled() const;
         void window_enabled(bool value);
+
+        // The mode is switched when the next frame starts
+        render_mode mode() const;
+        void mode(render_mode value);
+
+        // The renderer is switched when the next frame starts
+        renderer_type backend() const;
+        void backend(renderer_type value);
+
+        // VRAM, OAM and the LCDC-WX registers
+        byte load(word address) const;
+        void store(word address, byte value);
+
+        // Advance the lcd by the given amount of cycles
+        void tick(dword cycles);
+
+        byte ly() const;
+        dword frame_count() const;
+
+        // The cycles until the current frame ends (the lcd is enabled)
+        dword cycles_to_frame_end() const;
+
+        // The last completed frame, in deferred_async the one before it
+        const frame& screen();
+
+        // When off the screen is not drawn, only the pixel fifo still runs because the
+        // length of mode 3 depends on it. Switched between frames
+        bool draw() const;
+        void draw(bool value);
+
+        // The memory of the renderers, the write queue and the video memory that isn't shared, in bytes
+        size_t heap_size() const;
+
+        // The video memory is shared with the other lcd until one of them writes it, for forking a runner
+        void share(const lcd& other);
+
+        // The video state and the timing, without the render mode and the backend: a state is loaded
+        // into any of them. The screen is not a part of the state
+        void save(state::snapshot& snapshot);
+        void load(state::snapshot& snapshot);
     };
 }
-
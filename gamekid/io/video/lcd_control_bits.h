@@ -0,0 +1,13 @@
+#pragma once
+#include <gamekid/utils/types.h>
+
+namespace gamekid::io::video::lcd_control_bits {
+    const byte lcd_display_enable = 7;
+    const byte window_tile_map_display_select = 6;
+    const byte window_display_enable = 5;
+    const byte bg_window_tile_data_select = 4;
+    const byte bg_tile_map_display_select = 3;
+    const byte sprite_size = 2;
+    const byte sprite_display_enable = 1;
+    const byte bg_display = 0;
+}
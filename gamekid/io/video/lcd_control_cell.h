@@ -10,6 +10,7 @@ namespace gamekid::io::video {
         lcd& _lcd;
     public:
         explicit lcd_control_cell(lcd& lcd);
+        byte load() override;
         void store(byte value) override;
     };
 }
@@ -0,0 +1,13 @@
+#include "lcd_register_cell.h"
+
+gamekid::io::video::lcd_register_cell::lcd_register_cell(lcd& lcd, word address) : 
+_lcd(lcd), _address(address) {
+}
+
+byte gamekid::io::video::lcd_register_cell::load() {
+    return _lcd.load(_address);
+}
+
+void gamekid::io::video::lcd_register_cell::store(byte value) {
+    _lcd.store(_address, value);
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "lcd.h"
+#include "gamekid/memory/cell.h"
+
+namespace gamekid::io::video {
+    // A video register (STAT, SCY, SCX, LY, ...) which is kept in the lcd
+    class lcd_register_cell : public memory::cell {
+    private:
+        lcd& _lcd;
+        word _address;
+    public:
+        lcd_register_cell(lcd& lcd, word address);
+        byte load() override;
+        void store(byte value) override;
+    };
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <gamekid/utils/types.h>
+
+namespace gamekid::io::video::lcd_timing {
+    const dword
+        oam_search_cycles = 80,
+        pixel_transfer_cycles = 172,
+        cycles_per_line = 456,
+        visible_lines = 144,
+        lines_per_frame = 154,
+        vblank_start = visible_lines * cycles_per_line,
+        cycles_per_frame = lines_per_frame * cycles_per_line,
+        // the dot clock is the cpu clock
+        cycles_per_second = 4194304;
+
+    // the cycle in the frame in which the line pixels are transfered to the screen
+    constexpr dword line_render_cycle(byte line) {
+        return line * cycles_per_line + oam_search_cycles;
+    }
+}
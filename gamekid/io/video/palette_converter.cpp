@@ -0,0 +1,50 @@
+#include "palette_converter.h"
+
+namespace gamekid::io::video {
+
+    // the shades of the windows of the debugger and the emulator
+    const std::array<byte, 4> shades = { 0xFF, 0x99, 0x55, 0x00 };
+
+    std::array<dword, 4> rgba8888_palette() {
+        std::array<dword, 4> palette;
+
+        for (size_t i = 0; i < shades.size(); ++i) {
+            palette[i] = (shades[i] << 24) | (shades[i] << 16) | (shades[i] << 8) | 0xFF;
+        }
+
+        return palette;
+    }
+
+    std::array<word, 4> rgb565_palette() {
+        std::array<word, 4> palette;
+
+        for (size_t i = 0; i < shades.size(); ++i) {
+            palette[i] = static_cast<word>(((shades[i] >> 3) << 11) | ((shades[i] >> 2) << 5) | (shades[i] >> 3));
+        }
+
+        return palette;
+    }
+
+    std::array<byte, 4> grayscale_palette() {
+        return shades;
+    }
+
+    void pack_2bpp(const byte* pixels, size_t count, byte* out) {
+        size_t i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+            *out++ = (pixels[i] & 0b11) | (pixels[i + 1] & 0b11) << 2 |
+                (pixels[i + 2] & 0b11) << 4 | (pixels[i + 3] & 0b11) << 6;
+        }
+
+        if (i < count) {
+            byte last = 0;
+
+            for (size_t shift = 0; i < count; ++i, shift += 2) {
+                last |= (pixels[i] & 0b11) << shift;
+            }
+
+            *out = last;
+        }
+    }
+}
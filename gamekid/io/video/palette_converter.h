@@ -0,0 +1,84 @@
+#pragma once
+#include <gamekid/utils/types.h>
+#include <array>
+#include <cstring>
+
+namespace gamekid::io::video {
+
+    // Palettes of the 4 dmg shades (white to black) in the output formats
+    std::array<dword, 4> rgba8888_palette();
+    std::array<word, 4> rgb565_palette();
+    std::array<byte, 4> grayscale_palette();
+
+    // Converts indexed pixels (a 0-3 color per byte, like video::frame) through a palette.
+    // Every 4 input pixels form a byte key into a table of the 4 converted pixels,
+    // so the inner loop is a table load and a 4 pixel store instead of 4 palette lookups.
+    template <typename Pixel>
+    class palette_converter {
+    private:
+        using quad = std::array<Pixel, 4>;
+        std::array<Pixel, 4> _palette;
+        std::array<quad, 256> _quads;
+
+        static byte quad_key(const byte* pixels) {
+            return (pixels[0] & 0b11) | (pixels[1] & 0b11) << 2 | (pixels[2] & 0b11) << 4 | (pixels[3] & 0b11) << 6;
+        }
+    public:
+        explicit palette_converter(const std::array<Pixel, 4>& palette) : _palette(palette) {
+            for (size_t key = 0; key < _quads.size(); ++key) {
+                for (size_t i = 0; i < 4; ++i) {
+                    _quads[key][i] = palette[(key >> (i * 2)) & 0b11];
+                }
+            }
+        }
+
+        // Converts one row of width pixels into width * scale output pixels
+        void convert_row(const byte* pixels, int width, Pixel* out, int scale = 1) const {
+            int x = 0;
+
+            if (scale == 1) {
+                for (; x + 4 <= width; x += 4, out += 4) {
+                    std::memcpy(out, _quads[quad_key(pixels + x)].data(), sizeof(quad));
+                }
+            } else {
+                for (; x + 4 <= width; x += 4) {
+                    const quad& q = _quads[quad_key(pixels + x)];
+
+                    for (int i = 0; i < 4; ++i) {
+                        for (int s = 0; s < scale; ++s) {
+                            *out++ = q[i];
+                        }
+                    }
+                }
+            }
+
+            // widths that are not a multiple of 4
+            for (; x < width; ++x) {
+                for (int s = 0; s < scale; ++s) {
+                    *out++ = _palette[pixels[x] & 0b11];
+                }
+            }
+        }
+
+        // Converts a width x height image into a (width * scale) x (height * scale) image
+        void convert(const byte* pixels, int width, int height, Pixel* out, int scale = 1) const {
+            const int out_width = width * scale;
+
+            for (int y = 0; y < height; ++y) {
+                convert_row(pixels + y * width, width, out, scale);
+
+                // the other rows of the scaled row are copies
+                for (int s = 1; s < scale; ++s) {
+                    std::memcpy(out + s * out_width, out, out_width * sizeof(Pixel));
+                }
+
+                out += out_width * scale;
+            }
+        }
+    };
+
+    // Packs indexed pixels into 2 bits per pixel, 4 pixels per byte (the first pixel in the low bits).
+    // The packed form is only used for hashing and comparing, so it is not scaled.
+    // out must hold (count + 3) / 4 bytes.
+    void pack_2bpp(const byte* pixels, size_t count, byte* out);
+}
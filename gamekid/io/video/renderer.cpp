@@ -0,0 +1,14 @@
+#include "renderer.h"
+#include "scanline_renderer.h"
+#include "fifo_renderer.h"
+
+std::unique_ptr<gamekid::io::video::renderer> gamekid::io::video::renderer::create(renderer_type type) {
+    switch (type) {
+    case renderer_type::per_line:
+        return std::make_unique<scanline_renderer>();
+    case renderer_type::pixel_fifo:
+        return std::make_unique<fifo_renderer>();
+    default:
+        throw std::exception("Unknown renderer type");
+    }
+}
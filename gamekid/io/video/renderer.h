@@ -0,0 +1,28 @@
+#pragma once
+#include "frame.h"
+#include "video_state.h"
+#include <memory>
+
+namespace gamekid::io::video {
+    enum class renderer_type {
+        // draws a whole line at once when the pixel transfer starts (cheap)
+        per_line,
+        // dot accurate fetcher and pixel fifo, mode 3 has a variable length
+        pixel_fifo
+    };
+
+    class renderer {
+    public:
+        virtual ~renderer() = default;
+
+        virtual void begin_frame() = 0;
+
+        // Draws whatever the ppu draws between the two cycles of the frame ([from_cycle, to_cycle))
+        virtual void render(const video_state& state, dword from_cycle, dword to_cycle, frame& target) = 0;
+
+        // The length of the pixel transfer (mode 3) of the current line
+        virtual dword pixel_transfer_cycles() const = 0;
+
+        static std::unique_ptr<renderer> create(renderer_type type);
+    };
+}
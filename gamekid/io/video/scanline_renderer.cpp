@@ -0,0 +1,148 @@
+#include "scanline_renderer.h"
+#include "lcd_control_bits.h"
+#include "lcd_timing.h"
+#include "tile_data.h"
+#include <gamekid/utils/bits.h>
+#include <algorithm>
+
+using namespace gamekid::io::video;
+using namespace gamekid::io::video::tile_data;
+using gamekid::utils::bits::check_bit;
+
+void scanline_renderer::begin_frame() {
+    _window_line = 0;
+}
+
+void scanline_renderer::render(const video_state& state, dword from_cycle, dword to_cycle, frame& target) {
+    for (dword line = from_cycle / lcd_timing::cycles_per_line; line < lcd_timing::visible_lines; ++line) {
+        const dword render_cycle = lcd_timing::line_render_cycle(static_cast<byte>(line));
+
+        if (render_cycle >= to_cycle) {
+            break;
+        }
+
+        if (render_cycle >= from_cycle) {
+            render_line(state, static_cast<byte>(line), target);
+        }
+    }
+}
+
+dword scanline_renderer::pixel_transfer_cycles() const {
+    return lcd_timing::pixel_transfer_cycles;
+}
+
+void scanline_renderer::render_line(const video_state& state, byte line, frame& target) {
+    byte* pixels = target.data() + line * screen_width;
+    const byte lcdc = state.reg(LCDC);
+
+    if (check_bit(lcdc, lcd_control_bits::bg_display)) {
+        render_background(state, line, pixels);
+        render_window(state, line, pixels);
+    } else {
+        _bg_colors.fill(0);
+        std::fill(pixels, pixels + screen_width, 0);
+    }
+
+    if (check_bit(lcdc, lcd_control_bits::sprite_display_enable)) {
+        render_sprites(state, line, pixels);
+    }
+}
+
+void scanline_renderer::render_background(const video_state& state, byte line, byte* pixels) {
+    const byte lcdc = state.reg(LCDC);
+    const byte bgp = state.reg(BGP);
+    const byte y = static_cast<byte>(state.reg(SCY) + line);
+    const word map = check_bit(lcdc, lcd_control_bits::bg_tile_map_display_select) ? 
+        tile_map_high : tile_map_low;
+    const byte* map_row = state.vram.data() + map + (y / 8) * 32;
+    const byte scx = state.reg(SCX);
+
+    for (int x = 0; x < screen_width; ++x) {
+        const byte map_x = static_cast<byte>(scx + x);
+        const byte* row = state.vram.data() + bg_tile_row(lcdc, map_row[map_x / 8], y % 8);
+        const byte color = row_color(row, map_x % 8);
+        _bg_colors[x] = color;
+        pixels[x] = apply_pallete(bgp, color);
+    }
+}
+
+void scanline_renderer::render_window(const video_state& state, byte line, byte* pixels) {
+    const byte lcdc = state.reg(LCDC);
+    const int window_x = state.reg(WX) - 7;
+
+    if (!check_bit(lcdc, lcd_control_bits::window_display_enable) ||
+        line < state.reg(WY) || window_x >= screen_width) {
+        return;
+    }
+
+    const byte bgp = state.reg(BGP);
+    const word map = check_bit(lcdc, lcd_control_bits::window_tile_map_display_select) ? 
+        tile_map_high : tile_map_low;
+    const byte* map_row = state.vram.data() + map + (_window_line / 8) * 32;
+
+    for (int x = std::max(window_x, 0); x < screen_width; ++x) {
+        const byte map_x = static_cast<byte>(x - window_x);
+        const byte* row = state.vram.data() + bg_tile_row(lcdc, map_row[map_x / 8], _window_line % 8);
+        const byte color = row_color(row, map_x % 8);
+        _bg_colors[x] = color;
+        pixels[x] = apply_pallete(bgp, color);
+    }
+
+    ++_window_line;
+}
+
+void scanline_renderer::render_sprites(const video_state& state, byte line, byte* pixels) {
+    const byte lcdc = state.reg(LCDC);
+    const byte height = check_bit(lcdc, lcd_control_bits::sprite_size) ? 16 : 8;
+
+    // OAM search - the first 10 sprites (in oam order) that are on this line
+    std::array<byte, sprites_per_line> visible{};
+    byte count = 0;
+
+    for (byte i = 0; i < oam_size / 4 && count < sprites_per_line; ++i) {
+        const int sprite_y = state.oam[i * 4] - 16;
+
+        if (line >= sprite_y && line < sprite_y + height) {
+            visible[count++] = i;
+        }
+    }
+
+    // the sprite with the lower x is on top, on a tie the first in the oam wins
+    std::stable_sort(visible.begin(), visible.begin() + count, [&](byte a, byte b) {
+        return state.oam[a * 4 + 1] < state.oam[b * 4 + 1];
+    });
+
+    // the first opaque sprite pixel wins, even when it is hidden behind the background
+    std::array<bool, screen_width> taken{};
+
+    for (byte i = 0; i < count; ++i) {
+        const byte* sprite = state.oam.data() + visible[i] * 4;
+        const int sprite_x = sprite[1] - 8;
+        const byte flags = sprite[3];
+        const byte pallete = state.reg(check_bit(flags, 4) ? OBP1 : OBP0);
+        const bool behind_bg = check_bit(flags, 7);
+
+        byte row_index = static_cast<byte>(line - (sprite[0] - 16));
+        if (check_bit(flags, 6)) row_index = height - 1 - row_index;
+
+        const byte tile_index = height == 16 ? (sprite[2] & 0xFE) : sprite[2];
+        const byte* row = state.vram.data() + tile_index * 16 + row_index * 2;
+
+        for (byte x = 0; x < 8; ++x) {
+            const int screen_x = sprite_x + x;
+
+            if (screen_x < 0 || screen_x >= screen_width || taken[screen_x]) continue;
+
+            const byte color = row_color(row, check_bit(flags, 5) ? 7 - x : x);
+
+            // color 0 is transparent for sprites
+            if (color == 0) continue;
+
+            taken[screen_x] = true;
+
+            if (!behind_bg || _bg_colors[screen_x] == 0) {
+                pixels[screen_x] = apply_pallete(pallete, color);
+            }
+        }
+    }
+}
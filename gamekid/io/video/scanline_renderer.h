@@ -0,0 +1,24 @@
+#pragma once
+#include "renderer.h"
+
+namespace gamekid::io::video {
+    // Draws a whole line at once from the video state (no pixel fifo)
+    class scanline_renderer : public renderer {
+    private:
+        // the window has its own line counter, it only advances on lines the window was drawn
+        byte _window_line = 0;
+
+        // the color index (before the pallete) of every background pixel in the line
+        std::array<byte, screen_width> _bg_colors{};
+
+        void render_background(const video_state& state, byte line, byte* pixels);
+        void render_window(const video_state& state, byte line, byte* pixels);
+        void render_sprites(const video_state& state, byte line, byte* pixels);
+    public:
+        void begin_frame() override;
+        void render(const video_state& state, dword from_cycle, dword to_cycle, frame& target) override;
+        dword pixel_transfer_cycles() const override;
+
+        void render_line(const video_state& state, byte line, frame& target);
+    };
+}
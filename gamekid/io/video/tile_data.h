@@ -0,0 +1,32 @@
+#pragma once
+#include <gamekid/utils/types.h>
+#include <gamekid/utils/bits.h>
+#include "lcd_control_bits.h"
+
+namespace gamekid::io::video::tile_data {
+    // offsets of the tile maps in the vram
+    const word tile_map_low = 0x1800;
+    const word tile_map_high = 0x1C00;
+
+    const byte sprites_per_line = 10;
+
+    inline byte apply_pallete(byte pallete, byte color_index) {
+        return (pallete >> (color_index * 2)) & 0b11;
+    }
+
+    // returns the color index of pixel x in a tile row (2 bytes)
+    inline byte row_color(const byte* row, byte x) {
+        const byte bit = 7 - x;
+        return ((row[0] >> bit) & 1) | (((row[1] >> bit) & 1) << 1);
+    }
+
+    // offset of a tile row in the vram for the bg / window tiles
+    inline word bg_tile_row(byte lcdc, byte tile_index, byte row) {
+        if (utils::bits::check_bit(lcdc, lcd_control_bits::bg_window_tile_data_select)) {
+            return tile_index * 16 + row * 2;
+        }
+
+        // 0x8800 addressing - the index is signed and relative to 0x9000
+        return static_cast<word>(0x1000 + static_cast<signed char>(tile_index) * 16 + row * 2);
+    }
+}
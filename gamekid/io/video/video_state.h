@@ -0,0 +1,132 @@
+#pragma once
+#include <gamekid/utils/types.h>
+#include <gamekid/io/io_registers.h>
+#include <gamekid/memory/memory_map_offsets.h>
+#include <gamekid/state/snapshot.h>
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace gamekid::io::video {
+    const word vram_size = 0x2000;
+    const word oam_size = 0xA0;
+
+    // Memory which the copies of a video state (and the lcds of forked runners) share until one of them
+    // writes it. The copies are made on the cpu thread, the async renderer's copy may be dropped on its worker
+    template <size_t Size>
+    class shared_bytes {
+    public:
+        using block = std::array<byte, Size>;
+    private:
+        std::shared_ptr<block> _block;
+
+        static const std::shared_ptr<block>& zeros() {
+            static const std::shared_ptr<block> value = std::make_shared<block>();
+            return value;
+        }
+
+        void own() {
+            if (_block.use_count() == 1) {
+                // the other copies were dropped, their reads of the block happened before this write
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return;
+            }
+
+            _block = std::make_shared<block>(*_block);
+        }
+    public:
+        // Starts as a shared block of zeros
+        shared_bytes() : _block(zeros()) {}
+
+        const byte* data() const { return _block->data(); }
+        static constexpr size_t size() { return Size; }
+        byte operator[](size_t index) const { return (*_block)[index]; }
+        const block& bytes() const { return *_block; }
+
+        void store(size_t index, byte value) {
+            own();
+            (*_block)[index] = value;
+        }
+
+        // Replaces the bytes, the block is kept if they are the same
+        void assign(const block& bytes) {
+            if (*_block == bytes) return;
+
+            if (_block.use_count() == 1) {
+                std::atomic_thread_fence(std::memory_order_acquire);
+                *_block = bytes;
+            } else {
+                _block = std::make_shared<block>(bytes);
+            }
+        }
+
+        bool shares(const shared_bytes& other) const {
+            return _block == other._block;
+        }
+
+        // The copies which refer to the block, with this one
+        long copies() const {
+            return _block.use_count();
+        }
+    };
+
+    // Everything the ppu reads in order to draw a line
+    struct video_state {
+        shared_bytes<vram_size> vram;
+        shared_bytes<oam_size> oam;
+
+        // LCDC to WX
+        std::array<byte, WX - LCDC + 1> registers{};
+
+        static bool is_vram(word address) {
+            return address >= memory::memory_map_offsets::video_ram &&
+                address < memory::memory_map_offsets::video_ram + vram_size;
+        }
+
+        static bool is_oam(word address) {
+            return address >= memory::memory_map_offsets::sprite_attribute_memory &&
+                address < memory::memory_map_offsets::sprite_attribute_memory + oam_size;
+        }
+
+        static bool is_register(word address) {
+            return address >= LCDC && address <= WX;
+        }
+
+        byte reg(word address) const {
+            return registers[address - LCDC];
+        }
+
+        byte load(word address) const {
+            if (is_vram(address)) return vram[address - memory::memory_map_offsets::video_ram];
+            if (is_oam(address)) return oam[address - memory::memory_map_offsets::sprite_attribute_memory];
+            if (is_register(address)) return registers[address - LCDC];
+            return 0xFF;
+        }
+
+        void store(word address, byte value) {
+            if (is_vram(address)) vram.store(address - memory::memory_map_offsets::video_ram, value);
+            else if (is_oam(address)) oam.store(address - memory::memory_map_offsets::sprite_attribute_memory, value);
+            else if (is_register(address)) registers[address - LCDC] = value;
+        }
+
+        void save(state::snapshot& snapshot) const {
+            snapshot.write(vram.bytes(), oam.bytes(), registers);
+        }
+
+        // The memory that didn't change keeps its block
+        void load(state::snapshot& snapshot) {
+            decltype(vram)::block vram_bytes;
+            decltype(oam)::block oam_bytes;
+            snapshot.read(vram_bytes, oam_bytes, registers);
+            vram.assign(vram_bytes);
+            oam.assign(oam_bytes);
+        }
+    };
+
+    // A single write to the video state, stamped with the cycle in the frame it happened in
+    struct video_write {
+        dword cycle;
+        word address;
+        byte value;
+    };
+}
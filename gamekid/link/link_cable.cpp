@@ -0,0 +1,111 @@
+#include "link_cable.h"
+#include <gamekid/runner.h>
+#include <algorithm>
+#include <thread>
+
+using gamekid::link::link_cable;
+
+link_cable::link_cable(dword min_window, dword max_window) :
+_min_window(min_window), _max_window(max_window), _window(max_window) {
+}
+
+void link_cable::run(runner& first, runner& second, std::uint64_t cycles) {
+    _runners = { &first, &second };
+    _cycles = cycles;
+    _boundary = std::min<std::uint64_t>(_window, cycles);
+    _arrived = 0;
+    _failed = false;
+    _errors = {};
+
+    // the serial ports stay linked, a transfer started at the end is shifted in the next run
+    first.serial().linked(true);
+    second.serial().linked(true);
+
+    std::thread second_side(&link_cable::run_side, this, 1);
+    run_side(0);
+    second_side.join();
+
+    for (const std::exception_ptr& error : _errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+void link_cable::run_side(size_t side) {
+    runner& runner = *_runners[side];
+    const std::uint64_t start = runner.scheduler().cycle();
+
+    // the boundary is only changed when both runners wait in meet()
+    std::uint64_t boundary = _boundary;
+
+    try {
+        while (boundary != finished) {
+            const std::uint64_t cycle = runner.scheduler().cycle() - start;
+
+            // a runner may be past the boundary by the end of its last instruction
+            if (cycle < boundary) {
+                runner.run_cycles(static_cast<dword>(boundary - cycle));
+            }
+
+            boundary = meet();
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _errors[side] = std::current_exception();
+        _failed = true;
+        _condition.notify_all();
+    }
+}
+
+std::uint64_t link_cable::meet() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (_failed) {
+        return finished;
+    }
+
+    const std::uint64_t generation = _generation;
+
+    if (++_arrived < _runners.size()) {
+        _condition.wait(lock, [this, generation]() { return _generation != generation || _failed; });
+        return _generation != generation ? _boundary : finished;
+    }
+
+    // the other runner waits, the last one to arrive links both
+    _arrived = 0;
+    next_window();
+    ++_generation;
+    _condition.notify_all();
+    return _boundary;
+}
+
+void link_cable::next_window() {
+    io::scheduler& first = _runners[0]->scheduler();
+    io::scheduler& second = _runners[1]->scheduler();
+
+    exchange(first.serial(), second.serial());
+    first.serial_sync().reschedule();
+    second.serial_sync().reschedule();
+    ++_windows;
+
+    const bool active = first.serial().active() || second.serial().active();
+    _window = active ? _min_window : std::min(_window * 2, _max_window);
+    _boundary = _boundary >= _cycles ? finished : std::min(_boundary + _window, _cycles);
+}
+
+dword link_cable::window() const {
+    return _window;
+}
+
+dword link_cable::windows() const {
+    return _windows;
+}
+
+void link_cable::exchange(io::serial& first, io::serial& second) {
+    const io::link_state first_state = first.state();
+    const io::link_state second_state = second.state();
+
+    first.link(second_state);
+    second.link(first_state);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <gamekid/io/serial.h>
+#include <gamekid/io/video/lcd_timing.h>
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+
+namespace gamekid {
+    class runner;
+}
+
+namespace gamekid::link {
+
+    // A link cable between the serial ports of two runners in the same process.
+    // Each runner runs on its own thread in windows of cycles, there is no per cycle
+    // synchronization. Both runners stop at the end of every window and the bytes of the
+    // transfers started in it are shifted, so a transfer completes at the end of the window
+    // (but not before the serial clock shifted 8 bits). The window shrinks to a single
+    // transfer while the serial ports are in use and grows back when they are idle.
+    class link_cable {
+    private:
+        static constexpr std::uint64_t finished = UINT64_MAX;
+
+        dword _min_window;
+        dword _max_window;
+        dword _window;
+        std::array<runner*, 2> _runners{};
+        std::uint64_t _cycles = 0;
+        // the end of the current window, in cycles since the start of run()
+        std::uint64_t _boundary = 0;
+
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        dword _arrived = 0;
+        std::uint64_t _generation = 0;
+        dword _windows = 0;
+        bool _failed = false;
+        std::array<std::exception_ptr, 2> _errors;
+
+        void run_side(size_t side);
+        // waits for the other runner at the window boundary, returns the next boundary (or finished)
+        std::uint64_t meet();
+        void next_window();
+    public:
+        explicit link_cable(dword min_window = io::serial::transfer_cycles,
+            dword max_window = io::video::lcd_timing::cycles_per_frame);
+
+        link_cable(const link_cable&) = delete;
+        link_cable& operator=(const link_cable&) = delete;
+
+        // Runs both runners for the given amount of cycles, each on its own thread.
+        // Throws the exception of a runner which failed
+        void run(runner& first, runner& second, std::uint64_t cycles);
+
+        // The size of the next window
+        dword window() const;
+
+        // The number of windows (synchronization points) so far
+        dword windows() const;
+
+        // Shifts the bytes of the transfers that wait for the link, both serial ports are
+        // at the window boundary (their own cycle)
+        static void exchange(io::serial& first, io::serial& second);
+    };
+}
@@ -0,0 +1,197 @@
+#include "socket.h"
+#include <exception>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+
+namespace {
+    using native_socket = SOCKET;
+    const std::intptr_t invalid_handle = static_cast<std::intptr_t>(INVALID_SOCKET);
+
+    void startup() {
+        static const bool started = []() {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+
+        if (!started) {
+            throw std::exception("WSAStartup failed");
+        }
+    }
+
+    void close_native(native_socket handle) {
+        closesocket(handle);
+    }
+
+    const int send_flags = 0;
+}
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    using native_socket = int;
+    const std::intptr_t invalid_handle = -1;
+
+    void startup() {
+    }
+
+    void close_native(native_socket handle) {
+        ::close(handle);
+    }
+
+    // a send to a peer which disconnected fails instead of raising SIGPIPE, which ends the process
+#ifdef MSG_NOSIGNAL
+    const int send_flags = MSG_NOSIGNAL;
+#else
+    const int send_flags = 0;
+#endif
+}
+#endif
+
+using gamekid::link::socket;
+
+namespace {
+    native_socket native(std::intptr_t handle) {
+        return static_cast<native_socket>(handle);
+    }
+
+    std::intptr_t open_tcp() {
+        startup();
+        const native_socket handle = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+        if (static_cast<std::intptr_t>(handle) == invalid_handle) {
+            throw std::exception("Cannot create a socket");
+        }
+
+        return static_cast<std::intptr_t>(handle);
+    }
+
+    // every exchange is a small message that is waited for, it must not be delayed
+    void no_delay(std::intptr_t handle) {
+        const int enabled = 1;
+        setsockopt(native(handle), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&enabled), sizeof(enabled));
+
+#ifdef SO_NOSIGPIPE
+        // the systems without MSG_NOSIGNAL turn SIGPIPE off on the socket
+        setsockopt(native(handle), SOL_SOCKET, SO_NOSIGPIPE, reinterpret_cast<const char*>(&enabled), sizeof(enabled));
+#endif
+    }
+
+    sockaddr_in address(const char* host, word port) {
+        sockaddr_in result{};
+        result.sin_family = AF_INET;
+        result.sin_port = htons(port);
+
+        if (inet_pton(AF_INET, host, &result.sin_addr) != 1) {
+            throw std::exception("Invalid address");
+        }
+
+        return result;
+    }
+}
+
+socket::socket(std::intptr_t handle) : _handle(handle) {
+}
+
+socket::socket(socket&& other) noexcept : _handle(other._handle) {
+    other._handle = invalid_handle;
+}
+
+gamekid::link::socket& socket::operator=(socket&& other) noexcept {
+    if (this != &other) {
+        close();
+        _handle = other._handle;
+        other._handle = invalid_handle;
+    }
+
+    return *this;
+}
+
+socket::~socket() {
+    close();
+}
+
+void socket::close() {
+    if (_handle != invalid_handle) {
+        close_native(native(_handle));
+        _handle = invalid_handle;
+    }
+}
+
+gamekid::link::socket socket::listen(word port) {
+    socket listener(open_tcp());
+    const sockaddr_in local = address("127.0.0.1", port);
+
+    if (bind(native(listener._handle), reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0 ||
+        ::listen(native(listener._handle), 1) != 0) {
+        throw std::exception("Cannot listen on the port");
+    }
+
+    return listener;
+}
+
+gamekid::link::socket socket::connect(const std::string& host, word port) {
+    socket connection(open_tcp());
+    const sockaddr_in remote = address(host.c_str(), port);
+
+    if (::connect(native(connection._handle), reinterpret_cast<const sockaddr*>(&remote), sizeof(remote)) != 0) {
+        throw std::exception("Cannot connect");
+    }
+
+    no_delay(connection._handle);
+    return connection;
+}
+
+word socket::port() const {
+    sockaddr_in local{};
+    socklen_t size = sizeof(local);
+
+    if (getsockname(native(_handle), reinterpret_cast<sockaddr*>(&local), &size) != 0) {
+        throw std::exception("Cannot get the port");
+    }
+
+    return ntohs(local.sin_port);
+}
+
+gamekid::link::socket socket::accept() const {
+    const native_socket handle = ::accept(native(_handle), nullptr, nullptr);
+
+    if (static_cast<std::intptr_t>(handle) == invalid_handle) {
+        throw std::exception("Cannot accept a connection");
+    }
+
+    no_delay(static_cast<std::intptr_t>(handle));
+    return socket(static_cast<std::intptr_t>(handle));
+}
+
+void socket::send(const byte* data, size_t size) {
+    while (size > 0) {
+        const auto sent = ::send(native(_handle), reinterpret_cast<const char*>(data), static_cast<int>(size), send_flags);
+
+        if (sent <= 0) {
+            throw std::exception("The connection was lost");
+        }
+
+        data += sent;
+        size -= sent;
+    }
+}
+
+void socket::receive(byte* data, size_t size) {
+    while (size > 0) {
+        const auto received = ::recv(native(_handle), reinterpret_cast<char*>(data), static_cast<int>(size), 0);
+
+        if (received <= 0) {
+            throw std::exception("The connection was lost");
+        }
+
+        data += received;
+        size -= received;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <gamekid/utils/types.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace gamekid::link {
+
+    // A blocking TCP socket (winsock or bsd sockets)
+    class socket {
+    private:
+        std::intptr_t _handle;
+
+        explicit socket(std::intptr_t handle);
+        void close();
+    public:
+        socket(socket&& other) noexcept;
+        socket& operator=(socket&& other) noexcept;
+        socket(const socket&) = delete;
+        socket& operator=(const socket&) = delete;
+        ~socket();
+
+        // Listens on the port of the loopback interface, port 0 picks a free port
+        static socket listen(word port);
+
+        // Connects to the host (a numeric address such as 127.0.0.1)
+        static socket connect(const std::string& host, word port);
+
+        // The local port
+        word port() const;
+
+        // Waits for a connection on a listening socket
+        socket accept() const;
+
+        // Sends or receives exactly size bytes, throws if the connection is lost
+        void send(const byte* data, size_t size);
+        void receive(byte* data, size_t size);
+    };
+}
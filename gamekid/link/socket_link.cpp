@@ -0,0 +1,121 @@
+#include "socket_link.h"
+#include <gamekid/runner.h>
+#include <algorithm>
+#include <array>
+
+using gamekid::link::socket_link;
+
+namespace {
+    // the window number, the link state (cycle, transfer start, SB, armed, active)
+    const size_t message_size = 4 + 8 + 8 + 3;
+    using message = std::array<byte, message_size>;
+
+    // little endian, the same on both ends
+    template <typename T>
+    byte* write(byte* data, T value) {
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            *data++ = static_cast<byte>(value >> (i * 8));
+        }
+
+        return data;
+    }
+
+    template <typename T>
+    const byte* read(const byte* data, T& value) {
+        value = 0;
+
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<T>(*data++) << (i * 8);
+        }
+
+        return data;
+    }
+
+    message encode(dword window, const gamekid::io::link_state& state) {
+        message encoded{};
+        byte* data = write(encoded.data(), window);
+        data = write(data, state.cycle);
+        data = write(data, state.transfer_start);
+        *data++ = state.data;
+        *data++ = state.armed ? 1 : 0;
+        *data = state.active ? 1 : 0;
+        return encoded;
+    }
+
+    gamekid::io::link_state decode(const message& encoded, dword& window) {
+        gamekid::io::link_state state{};
+        const byte* data = read(encoded.data(), window);
+        data = read(data, state.cycle);
+        data = read(data, state.transfer_start);
+        state.data = *data++;
+        state.armed = *data++ != 0;
+        state.active = *data != 0;
+        return state;
+    }
+}
+
+socket_link::socket_link(socket&& connection, dword min_window, dword max_window) :
+_socket(std::move(connection)), _min_window(min_window), _max_window(max_window), _window(max_window) {
+}
+
+void socket_link::exchange(io::serial& serial) {
+    const io::link_state state = serial.state();
+
+    // both ends send before they wait, a window costs a single one way trip
+    const message sent = encode(_windows, state);
+    _socket.send(sent.data(), sent.size());
+
+    message received{};
+    _socket.receive(received.data(), received.size());
+
+    dword other_window;
+    const io::link_state other = decode(received, other_window);
+
+    if (other_window != _windows) {
+        throw std::exception("The link is out of sync");
+    }
+
+    serial.link(other);
+    ++_windows;
+
+    // both ends know both states, they choose the same window
+    const bool active = state.active || other.active;
+    _window = active ? _min_window : std::min(_window * 2, _max_window);
+}
+
+void socket_link::run(runner& runner, std::uint64_t cycles) {
+    io::scheduler& scheduler = runner.scheduler();
+
+    if (!_started) {
+        _started = true;
+        _origin = scheduler.cycle();
+        _boundary = _window;
+        scheduler.serial().linked(true);
+    }
+
+    const std::uint64_t end = scheduler.cycle() + cycles;
+
+    while (scheduler.cycle() < end) {
+        const std::uint64_t boundary = _origin + _boundary;
+        const std::uint64_t target = std::min(boundary, end);
+
+        if (scheduler.cycle() < target) {
+            runner.run_cycles(static_cast<dword>(target - scheduler.cycle()));
+        }
+
+        // a runner may be past the boundary by the end of its last instruction
+        if (scheduler.cycle() >= boundary) {
+            exchange(scheduler.serial());
+            scheduler.serial_sync().reschedule();
+            _boundary += _window;
+        }
+    }
+}
+
+dword socket_link::window() const {
+    return _window;
+}
+
+dword socket_link::windows() const {
+    return _windows;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "socket.h"
+#include <gamekid/io/serial.h>
+#include <gamekid/io/video/lcd_timing.h>
+#include <cstdint>
+
+namespace gamekid {
+    class runner;
+}
+
+namespace gamekid::link {
+
+    // A link cable to a runner in another process, over a local TCP connection.
+    // Both ends run in the same windows of emulated cycles (counted from the opcode cycles),
+    // so the synchronization points don't depend on the host's timing. At the end of every
+    // window each end sends its link state and waits for the other end's, then both shift the
+    // bits of the waiting transfers the same way. The same inputs give the same bytes.
+    // A window is a whole frame while the serial ports are idle, so there is one round trip
+    // per frame, and a single transfer while they are busy.
+    class socket_link {
+    private:
+        socket _socket;
+        dword _min_window;
+        dword _max_window;
+        dword _window;
+        dword _windows = 0;
+        // the runner's cycle when the link started and the end of the current window after it
+        std::uint64_t _origin = 0;
+        std::uint64_t _boundary = 0;
+        bool _started = false;
+    public:
+        explicit socket_link(socket&& connection, dword min_window = io::serial::transfer_cycles,
+            dword max_window = io::video::lcd_timing::cycles_per_frame);
+
+        // Exchanges the link states at the end of a window and chooses the next window
+        void exchange(io::serial& serial);
+
+        // Runs the runner for the given amount of cycles, stopping at the end of every window.
+        // The windows don't depend on the amount of cycles of each call
+        void run(runner& runner, std::uint64_t cycles);
+
+        // The size of the next window
+        dword window() const;
+
+        // The number of windows (synchronization points) so far
+        dword windows() const;
+    };
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <gamekid/utils/types.h>
+#include <array>
+#include <bitset>
+
+namespace gamekid::memory {
+
+    // The pages written through the memory, so a consumer (a snapshot, a comparison, a save of the cartridge ram)
+    // can visit only the pages that changed since it last looked.
+    // Every write stamps its page with the current epoch. A consumer keeps the epoch it started at and asks for
+    // the pages written since, consumers don't clear each other's pages.
+    // Only writes through the memory are seen, the io registers and the video memory also change on their own
+    class dirty_pages {
+    private:
+        std::array<dword, 256> _written{};
+        // pages which are mirrors of another page mark that page
+        std::array<byte, 256> _owners;
+        dword _epoch = 1;
+    public:
+        dirty_pages() {
+            for (size_t index = 0; index < _owners.size(); ++index) {
+                _owners[index] = static_cast<byte>(index);
+            }
+        }
+
+        // The writes to the page are written to the owner page
+        void mirror(byte index, byte owner) {
+            _owners[index] = owner;
+        }
+
+        void mark(byte index) {
+            _written[_owners[index]] = _epoch;
+        }
+
+        // Marks every page, for when the whole memory is replaced
+        void mark_all() {
+            _written.fill(_epoch);
+        }
+
+        // The epoch of the writes from now on
+        dword epoch() const {
+            return _epoch;
+        }
+
+        // Starts a new epoch, the writes before it are not in it
+        dword next_epoch() {
+            return ++_epoch;
+        }
+
+        bool dirty(byte index, dword since) const {
+            return _written[index] >= since;
+        }
+
+        std::bitset<256> since(dword epoch) const {
+            std::bitset<256> result;
+
+            for (size_t index = 0; index < _written.size(); ++index) {
+                result[index] = _written[index] >= epoch;
+            }
+
+            return result;
+        }
+
+        // Calls func with the index of every page written since the epoch
+        template <typename Func>
+        void for_each(dword since, Func func) const {
+            for (size_t index = 0; index < _written.size(); ++index) {
+                if (_written[index] >= since) {
+                    func(static_cast<byte>(index));
+                }
+            }
+        }
+
+        // The pages written since the epoch, which moves to a new one (reading and clearing for one consumer)
+        std::bitset<256> collect(dword& epoch) {
+            const std::bitset<256> result = since(epoch);
+            epoch = next_epoch();
+            return result;
+        }
+    };
+}
@@ -1,10 +1,13 @@
 #include "gameboy_memory_map.h"
 #include "memory_map_offsets.h"
+#include <gamekid/io/video/video_state.h>
+#include <gamekid/io/scheduler.h>
+#include <gamekid/state/snapshot.h>
 
 using gamekid::memory::gameboy_memory_map;
 
-gameboy_memory_map::gameboy_memory_map(gamekid::rom::rom_map& rom_map, gamekid::io::video::lcd& lcd): 
-_io_page(*this, lcd), _rom_map(rom_map) {
+gameboy_memory_map::gameboy_memory_map(gamekid::rom::rom_map& rom_map, gamekid::io::scheduler& scheduler): 
+_io_page(*this, scheduler), _rom_map(rom_map) {
     // Initialize hald of the pages with rom pages
     // Get the rom pages using the correct rom map
     _rom_map.fill_pages(pages);
@@ -22,8 +25,21 @@ _io_page(*this, lcd), _rom_map(rom_map) {
     for (int i = 0; i<0x1e; ++i) {
         pages[internal_ram_index + i] =
             pages[echo_ram_index + i];
+        dirty.mirror(static_cast<byte>(echo_ram_index + i), static_cast<byte>(internal_ram_index + i));
     }
 
+    // The VRAM and the OAM are kept in the lcd
+    const int video_ram_pages = io::video::vram_size / 256;
+    _video_pages.reserve(video_ram_pages + 1);
+
+    for (int i = 0; i < video_ram_pages; ++i) {
+        const word address = memory_map_offsets::video_ram + i * 256;
+        pages[page::index(address)] = &_video_pages.emplace_back(scheduler.lcd(), scheduler.lcd_sync(), address);
+    }
+
+    pages[page::index(memory_map_offsets::sprite_attribute_memory)] =
+        &_video_pages.emplace_back(scheduler.lcd(), scheduler.lcd_sync(), memory_map_offsets::sprite_attribute_memory);
+
     // Handle IO
     pages[io_page::io_page_memory >> 8] = &_io_page;
     pages[0] = &_boot_rom_page;
@@ -31,4 +47,54 @@ _io_page(*this, lcd), _rom_map(rom_map) {
 
 void gameboy_memory_map::disable_boot_rom() {
     pages[0] = _rom_map.get_page(0);
-}
\ No newline at end of file
+}
+
+void gameboy_memory_map::share(gameboy_memory_map& other) {
+    for (size_t index = 0; index < _normal_pages.size(); ++index) {
+        _normal_pages[index].share(other._normal_pages[index]);
+    }
+}
+
+size_t gameboy_memory_map::owned_pages() const {
+    size_t count = 0;
+
+    for (const normal_page& page : _normal_pages) {
+        if (page.owned()) ++count;
+    }
+
+    return count;
+}
+
+size_t gameboy_memory_map::shared_pages() const {
+    return _normal_pages.size() - owned_pages();
+}
+
+size_t gameboy_memory_map::heap_size() const {
+    return _video_pages.capacity() * sizeof(video_page);
+}
+
+void gameboy_memory_map::save(state::snapshot& snapshot) {
+    for (const normal_page& page : _normal_pages) {
+        snapshot.write(page.data());
+    }
+
+    _io_page.save(snapshot);
+    snapshot.write(pages[0] == &_boot_rom_page);
+}
+
+void gameboy_memory_map::load(state::snapshot& snapshot) {
+    // the pages that didn't change keep their blocks, a forked or rewound system doesn't copy them
+    normal_page::block bytes;
+
+    for (normal_page& page : _normal_pages) {
+        snapshot.read(bytes);
+        page.assign(bytes);
+    }
+
+    _io_page.load(snapshot);
+
+    bool boot_rom;
+    snapshot.read(boot_rom);
+    pages[0] = boot_rom ? &_boot_rom_page : _rom_map.get_page(0);
+    dirty.mark_all();
+}
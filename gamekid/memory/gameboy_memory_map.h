@@ -5,9 +5,11 @@
 #include "io_page.h"
 #include "gamekid/rom/rom_map.h"
 #include "boot_rom_page.h"
+#include "video_page.h"
+#include <vector>
 
-namespace gamekid::io::video {
-    class lcd;
+namespace gamekid::io {
+    class scheduler;
 }
 
 namespace gamekid::memory {
@@ -17,10 +19,26 @@ namespace gamekid::memory {
         std::array<normal_page, 128> _normal_pages;
         boot_rom_page _boot_rom_page;
         io_page _io_page;
+        std::vector<video_page> _video_pages;
         rom::rom_map& _rom_map;
     public:
-        explicit gameboy_memory_map(rom::rom_map& rom_map, io::video::lcd& lcd);
+        gameboy_memory_map(rom::rom_map& rom_map, io::scheduler& scheduler);
         void disable_boot_rom();
+
+        // The ram of both maps is shared until it is written (copy on write)
+        void share(gameboy_memory_map& other);
+
+        // The ram pages which have a block of their own, and the ones which share it
+        size_t owned_pages() const;
+        size_t shared_pages() const;
+
+        // The memory of the video pages, in bytes (the ram is counted by pages)
+        size_t heap_size() const;
+
+        // The ram, the io page and whether the boot rom is mapped.
+        // The video memory belongs to the lcd and the rom doesn't change
+        void save(state::snapshot& snapshot);
+        void load(state::snapshot& snapshot);
     };
 }
 
@@ -1,16 +1,68 @@
 #include "io_page.h"
 #include "gamekid/io/io_registers.h"
+#include "gamekid/io/scheduler.h"
+#include "gamekid/state/snapshot.h"
 
-gamekid::memory::io_page::io_page(gameboy_memory_map& memory_map, io::video::lcd& lcd) :
-_boot_rom_status_cell(memory_map), _lcd_control(lcd),
+gamekid::memory::io_page::io_page(gameboy_memory_map& memory_map, io::scheduler& scheduler) :
+_boot_rom_status_cell(memory_map), _lcd_control(scheduler.lcd()),
 _cells({}), _normal_cells({}) {
     
     for (size_t i = 0; i < _normal_cells.size(); ++i) {
         _cells[i] = &_normal_cells[i];
     }
 
-    _cells[P1 - io_page_memory] = &_joypad_cell;
+    _cells[P1 - io_page_memory] = &scheduler.joypad().cell();
     _cells[ENABLE_BOOT_ROM - io_page_memory] = &_boot_rom_status_cell;
+    _cells[LCDC - io_page_memory] = &_lcd_control;
+
+    _serial_registers.reserve(SC - SB + 1);
+
+    for (word address = SB; address <= SC; ++address) {
+        _cells[address - io_page_memory] = &_serial_registers.emplace_back(scheduler.serial(), address);
+    }
+
+    // The divider and the timer are computed from the cycle count in the timer
+    _timer_registers.reserve(TAC - DIV + 1);
+
+    for (word address = DIV; address <= TAC; ++address) {
+        _cells[address - io_page_memory] = &_timer_registers.emplace_back(scheduler.timer(), address);
+    }
+
+    // DMA is not a video register, it is a normal cell for now
+    _lcd_registers.reserve(WX - STAT + 1);
+
+    for (word address = STAT; address <= WX; ++address) {
+        if (address != DMA) {
+            _cells[address - io_page_memory] = &_lcd_registers.emplace_back(scheduler.lcd(), address);
+        }
+    }
+
+    // The sound registers and the wave pattern ram are kept in the apu
+    _apu_registers.reserve(io::audio::apu::last_register - io::audio::apu::first_register + 1);
+
+    for (word address = io::audio::apu::first_register; address <= io::audio::apu::last_register; ++address) {
+        _cells[address - io_page_memory] = &_apu_registers.emplace_back(scheduler.apu(), address);
+    }
+
+    // The lcd, the apu, the timer, the serial port and the joypad input run behind the cpu, 
+    // they are caught up before any of their registers is accessed
+    const auto sync_registers = [this](word first, word last, io::catch_up& sync) {
+        for (word address = first; address <= last; ++address) {
+            if (address != DMA) {
+                cell& registers_cell = *_cells[address - io_page_memory];
+                _cells[address - io_page_memory] = &_synced_cells.emplace_back(registers_cell, sync);
+            }
+        }
+    };
+
+    _synced_cells.reserve(1 + (SC - SB + 1) + (TAC - DIV + 1) + (WX - LCDC) + 
+        (io::audio::apu::last_register - io::audio::apu::first_register + 1));
+
+    sync_registers(P1, P1, scheduler.joypad_sync());
+    sync_registers(SB, SC, scheduler.serial_sync());
+    sync_registers(DIV, TAC, scheduler.timer_sync());
+    sync_registers(LCDC, WX, scheduler.lcd_sync());
+    sync_registers(io::audio::apu::first_register, io::audio::apu::last_register, scheduler.apu_sync());
 }
 
 byte gamekid::memory::io_page::load(byte offset) {
@@ -20,3 +72,26 @@ byte gamekid::memory::io_page::load(byte offset) {
 void gamekid::memory::io_page::store(byte offset, byte value) {
     _cells[offset]->store(value);
 }
+
+void gamekid::memory::io_page::save(state::snapshot& snapshot) {
+    std::array<byte, 256> values;
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = _normal_cells[i].load();
+    }
+
+    snapshot.write(values, _boot_rom_status_cell.load());
+}
+
+void gamekid::memory::io_page::load(state::snapshot& snapshot) {
+    std::array<byte, 256> values;
+    byte boot_rom_status;
+    snapshot.read(values, boot_rom_status);
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        _normal_cells[i].store(values[i]);
+    }
+
+    // the boot rom page is mapped by the memory map
+    _boot_rom_status_cell.cell::store(boot_rom_status);
+}
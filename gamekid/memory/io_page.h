@@ -1,12 +1,21 @@
 #pragma once
 #include "page.h"
-#include <gamekid/io/joypad_cell.h>
 #include <gamekid/io/boot_rom_status_cell.h>
+#include <gamekid/io/timer_register_cell.h>
+#include <gamekid/io/serial_register_cell.h>
+#include <gamekid/io/synced_cell.h>
 #include <gamekid/io/video/lcd_control_cell.h>
+#include <gamekid/io/video/lcd_register_cell.h>
+#include <gamekid/io/audio/apu_register_cell.h>
+#include <vector>
 #include <array>
 
-namespace gamekid::io::video {
-    class lcd;
+namespace gamekid::io {
+    class scheduler;
+}
+
+namespace gamekid::state {
+    class snapshot;
 }
 
 namespace gamekid::memory {
@@ -14,15 +23,23 @@ namespace gamekid::memory {
 
     class io_page : public page {
     private:
-        io::joypad_cell _joypad_cell;
         io::boot_rom_status_cell _boot_rom_status_cell;
         io::video::lcd_control_cell _lcd_control;
+        std::vector<io::serial_register_cell> _serial_registers;
+        std::vector<io::timer_register_cell> _timer_registers;
+        std::vector<io::video::lcd_register_cell> _lcd_registers;
+        std::vector<io::audio::apu_register_cell> _apu_registers;
+        std::vector<io::synced_cell> _synced_cells;
         std::array<cell*, 256> _cells;
         std::array<cell, 256> _normal_cells;
     public:
         static const word io_page_memory = 0xFF00;
-        explicit io_page(gameboy_memory_map& memory_map, io::video::lcd& lcd);
+        io_page(gameboy_memory_map& memory_map, io::scheduler& scheduler);
         byte load(byte offset) override;
         void store(byte offset, byte value) override;
+
+        // The cells which are not registers of a component (and the boot rom status)
+        void save(state::snapshot& snapshot);
+        void load(state::snapshot& snapshot);
     };
 }
@@ -13,6 +13,7 @@ byte gamekid::memory::memory::load_byte(word address) {
 
 void gamekid::memory::memory::store_byte(word address, byte value) {
     _map.pages[address >> 8]->store(address & 0xFF, value);
+    _map.dirty.mark(static_cast<byte>(address >> 8));
 }
 
 void gamekid::memory::memory::store_word(word address, word value) {
@@ -1,11 +1,14 @@
 #pragma once
 #include <array>
 #include "page.h"
+#include "dirty_pages.h"
 
 namespace gamekid::memory {
     class memory_map {
     public:
         std::array<page*, 256> pages;
+        // The pages written through the memory
+        dirty_pages dirty;
         virtual ~memory_map() = default;
     };
 }
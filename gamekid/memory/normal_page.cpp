@@ -0,0 +1,39 @@
+#include "normal_page.h"
+
+using gamekid::memory::normal_page;
+
+namespace {
+    const std::shared_ptr<normal_page::block>& zeros() {
+        static const std::shared_ptr<normal_page::block> block = std::make_shared<normal_page::block>();
+        return block;
+    }
+}
+
+normal_page::normal_page() : _block(zeros()), _bytes(_block->data()) {
+}
+
+void normal_page::own() {
+    _block = std::make_shared<block>(*_block);
+    _bytes = _block->data();
+    _owned = true;
+}
+
+void normal_page::assign(const block& bytes) {
+    if (*_block == bytes) return;
+
+    if (!_owned) {
+        _block = std::make_shared<block>();
+        _bytes = _block->data();
+        _owned = true;
+    }
+
+    *_block = bytes;
+}
+
+void normal_page::share(normal_page& other) {
+    // neither of them can write the block anymore
+    other._owned = false;
+    _block = other._block;
+    _bytes = _block->data();
+    _owned = false;
+}
@@ -1,19 +1,49 @@
 #pragma once
 #include "page.h"
 #include <array>
-#include "cell.h"
+#include <memory>
 
 namespace gamekid::memory {
+    // Plain ram. The bytes are kept in one block which can be shared with the pages of forked systems,
+    // a shared block is never written, the page copies it on its first write
     class normal_page : public page {
+    public:
+        using block = std::array<byte, 256>;
     private:
-        std::array<cell, 256> _cells;
+        std::shared_ptr<block> _block;
+        byte* _bytes;
+        // only this page refers to the block
+        bool _owned = false;
+
+        void own();
     public:
+        // The page starts as a shared block of zeros
+        normal_page();
+        normal_page(const normal_page&) = delete;
+        normal_page& operator=(const normal_page&) = delete;
+
         byte load(byte offset) override {
-            return _cells[offset].load();
+            return _bytes[offset];
         }
 
         void store(byte offset, byte value) override {
-            _cells[offset].store(value);
+            if (!_owned) own();
+            _bytes[offset] = value;
+        }
+
+        const block& data() const {
+            return *_block;
+        }
+
+        // Replaces the bytes, the block is kept if they are the same
+        void assign(const block& bytes);
+
+        // The page shares the block of the other page until one of them writes
+        void share(normal_page& other);
+
+        // Whether the page has a block of its own
+        bool owned() const {
+            return _owned;
         }
     };
 }
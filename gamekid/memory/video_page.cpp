@@ -0,0 +1,17 @@
+#include "video_page.h"
+#include <gamekid/io/video/lcd.h>
+#include <gamekid/io/catch_up.h>
+
+gamekid::memory::video_page::video_page(io::video::lcd& lcd, io::catch_up& sync, word address) :
+_lcd(lcd), _sync(sync), _address(address){
+}
+
+byte gamekid::memory::video_page::load(byte offset) {
+    _sync.sync();
+    return _lcd.load(_address + offset);
+}
+
+void gamekid::memory::video_page::store(byte offset, byte value) {
+    _sync.sync();
+    _lcd.store(_address + offset, value);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "page.h"
+
+namespace gamekid::io::video {
+    class lcd;
+}
+
+namespace gamekid::io {
+    class catch_up;
+}
+
+namespace gamekid::memory {
+    // A page of the VRAM or the OAM, the memory is kept in the lcd
+    // which is caught up before it is accessed
+    class video_page : public page {
+    private:
+        io::video::lcd& _lcd;
+        io::catch_up& _sync;
+        word _address;
+    public:
+        video_page(io::video::lcd& lcd, io::catch_up& sync, word address);
+        byte load(byte offset) override;
+        void store(byte offset, byte value) override;
+    };
+}
@@ -4,34 +4,34 @@
 
 using namespace gamekid::rom;
 
-cartridge::cartridge(std::vector<byte>&& rom): _rom(std::move(rom)) {
+cartridge::cartridge(std::vector<byte>&& rom): _rom(std::make_shared<const std::vector<byte>>(std::move(rom))) {
 }
 
 const std::vector<byte>& gamekid::rom::cartridge::data() const {
-    return _rom;
+    return *_rom;
 }
 
 std::string cartridge::title() const {
-    const char* title_ptr = header_offsets::title.start + (char*)_rom.data();
+    const char* title_ptr = header_offsets::title.start + (char*)_rom->data();
     const size_t length = strnlen_s(title_ptr, header_offsets::title.length);
     return std::string(title_ptr, length);
 }
 
 const byte* cartridge::logo() const {
-    return _rom.data() + header_offsets::logo.start;
+    return _rom->data() + header_offsets::logo.start;
 }
 
 byte cartridge::cgb_flag() const {
-    return _rom[header_offsets::cgb_flag.start];
+    return (*_rom)[header_offsets::cgb_flag.start];
 }
 
 word cartridge::new_licensee_code() const {
-    return _rom[header_offsets::new_licensee_code.start];
+    return (*_rom)[header_offsets::new_licensee_code.start];
 }
 
 destination_code cartridge::dest_code() const {
 
-    const byte value = _rom[header_offsets::dest_code.start];
+    const byte value = (*_rom)[header_offsets::dest_code.start];
 
     if (!is_destination_code_valid(value)) {
         throw std::exception("Destination code is not valid");
@@ -42,7 +42,7 @@ destination_code cartridge::dest_code() const {
 
 ram_size cartridge::ram_size() const {
     
-    const byte ram_size_byte = _rom[header_offsets::ram_size.start];
+    const byte ram_size_byte = (*_rom)[header_offsets::ram_size.start];
 
     if (!is_ram_size_valid(ram_size_byte)) {
         throw std::exception("Ram size is not valid");
@@ -52,26 +52,26 @@ ram_size cartridge::ram_size() const {
 }
 
 byte cartridge::old_licensee_code() const {
-    return _rom[header_offsets::old_licensee_code.start];
+    return (*_rom)[header_offsets::old_licensee_code.start];
 }
 
 byte cartridge::mask_rom_version() const {
-    return _rom[header_offsets::mask_rom_version.start];
+    return (*_rom)[header_offsets::mask_rom_version.start];
 }
 
 byte cartridge::header_checksum() const {
-    return _rom[header_offsets::header_checksum.start];
+    return (*_rom)[header_offsets::header_checksum.start];
 }
 
 word cartridge::global_checksum() const {
-    return _rom[header_offsets::global_checksum.start];
+    return (*_rom)[header_offsets::global_checksum.start];
 }
 
 byte cartridge::calculate_header_checksum() const {
     byte checksum = 0;
 
     for (size_t i = header_offsets::title.start; i < header_offsets::header_checksum.start; ++i) {
-        checksum = checksum - _rom[i] - 1;
+        checksum = checksum - (*_rom)[i] - 1;
     }
 
     return checksum;
@@ -87,11 +87,11 @@ word cartridge::calculate_global_checksum() const {
     size_t i;
 
     for (i = 0; i < header_offsets::global_checksum.start; ++i) {
-        checksum += _rom[i];
+        checksum += (*_rom)[i];
     }
 
-    for (i += header_offsets::global_checksum.length; i<_rom.size(); ++i) {
-        checksum += _rom[i];
+    for (i += header_offsets::global_checksum.length; i<_rom->size(); ++i) {
+        checksum += (*_rom)[i];
     }
 
     return checksum;
@@ -102,7 +102,7 @@ bool cartridge::validate_global_checksum() const {
 }
 
 std::unique_ptr<rom_map> cartridge::create_rom_map() const {
-    switch (_rom[header_offsets::cartridge_type.start]) {
+    switch ((*_rom)[header_offsets::cartridge_type.start]) {
     case (byte)cartridge_type::rom_only:
         return std::make_unique<rom_only_map>(*this);
     default:
@@ -111,11 +111,11 @@ std::unique_ptr<rom_map> cartridge::create_rom_map() const {
 }
 
 byte cartridge::sgb_flag() const {
-    return _rom[header_offsets::sdb_flag.start];
+    return (*_rom)[header_offsets::sdb_flag.start];
 }
 
 rom_size cartridge::rom_size() const {
-    const byte rom_size_byte = _rom[header_offsets::rom_size.start];
+    const byte rom_size_byte = (*_rom)[header_offsets::rom_size.start];
 
     if (!is_rom_size_valid(rom_size_byte))
         throw std::exception("Rom size byte is not valid");
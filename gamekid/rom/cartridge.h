@@ -7,9 +7,10 @@
 #include "rom_map.h"
 
 namespace gamekid::rom {
+    // The rom is immutable, copies of a cartridge share it
     class cartridge {
     private:
-        std::vector<byte> _rom;
+        std::shared_ptr<const std::vector<byte>> _rom;
     public:
         explicit cartridge(std::vector<byte>&& rom);
         const std::vector<byte>& data() const;
@@ -1,19 +1,113 @@
 #include "runner.h"
+#include "io/video/lcd_timing.h"
+#include "io/io_registers.h"
 #include "rom/cartridge.h"
+#include "rom/cartridge_header.h"
 #include "utils/convert.h"
 #include "utils/str.h"
+#include "utils/bytes.h"
+#include <chrono>
 
 using namespace gamekid;
 
+namespace {
+    // where the boot rom leaves the lcd (cycles since it turned it on, modulo a frame) and DIV's counter
+    // (the cycles since power on, modulo 0x10000) when it jumps to 0x100, measured by running it.
+    // SKIPPING_THE_BOOT_ROM_LEAVES_THE_SAME_STATE checks them against the boot rom
+    const dword boot_lcd_cycle = 69924;
+    const dword boot_div_counter = 4620;
+    static_assert(boot_lcd_cycle < io::video::lcd_timing::cycles_per_frame);
+
+    // the cycles before the lcd is turned on which leave DIV and the apu's frame sequencer, which also
+    // count from power on, where the boot rom leaves them
+    const dword boot_lcd_off_cycles = (boot_div_counter - boot_lcd_cycle) & 0xFFFF;
+
+    // the (R) after the logo, a byte for every other row
+    const byte registered_mark[] = { 0x3C, 0x42, 0xB9, 0xA5, 0xB9, 0xA5, 0x42, 0x3C };
+
+    // the return addresses of the boot rom's calls are left in the stack
+    const byte boot_stack[] = { 0x39, 0x01, 0x2E };
+}
+
 runner::runner(rom::cartridge&& cart) : 
-_cart(cart), _rom_map(cart.create_rom_map()), _memory_map(*_rom_map, _lcd),
-_system(_memory_map), _set(_system.cpu()), _decoder(_set){
+_cart(std::move(cart)), _scheduler(_lcd, _apu, _timer, _serial, _joypad, [this](byte interrupt) { request_interrupt(interrupt); }),
+_rom_map(_cart.create_rom_map()), _memory_map(*_rom_map, _scheduler),
+_system(_memory_map), _decoder(cpu::opcode_decoder::shared()){
 
     if (!_cart.validate_header_checksum()) {
         throw std::exception("Header checksum error");
     }
 }
 
+void runner::skip_boot_rom() {
+    memory::memory& memory = _system.memory();
+
+    if (_system.cpu().PC.load() != 0 || memory.load_byte(ENABLE_BOOT_ROM) != 0) {
+        throw std::exception("The boot rom already ran");
+    }
+
+    // every nibble of the logo is a row of a tile, with its pixels doubled, drawn twice
+    const byte* logo = _cart.logo();
+    word address = 0x8010;
+
+    for (size_t index = 0; index < rom::size_of_nintendo_logo * 2; ++index) {
+        const byte nibble = (index % 2 == 0) ? logo[index / 2] >> 4 : logo[index / 2] & 0x0F;
+        byte row = 0;
+
+        for (int bit = 0; bit < 4; ++bit) {
+            if (nibble & (1 << bit)) {
+                row |= 0b11 << (bit * 2);
+            }
+        }
+
+        memory.store_byte(address, row);
+        memory.store_byte(address + 2, row);
+        address += 4;
+    }
+
+    for (const byte row : registered_mark) {
+        memory.store_byte(address, row);
+        address += 2;
+    }
+
+    // the logo's tiles 1-24 in two lines of the background, and the (R) after the first one
+    for (byte tile = 0; tile < 12; ++tile) {
+        memory.store_byte(0x9904 + tile, tile + 1);
+        memory.store_byte(0x9924 + tile, tile + 13);
+    }
+
+    memory.store_byte(0x9910, 25);
+
+    for (size_t index = 0; index < sizeof(boot_stack); ++index) {
+        memory.store_byte(static_cast<word>(0xFFFA + index), boot_stack[index]);
+    }
+
+    // the second note of the boot sound is triggered at a volume of 0, which it faded to
+    memory.store_byte(NR_52, 0x80);
+    memory.store_byte(NR_11, 0x80);
+    memory.store_byte(NR_12, 0x08);
+    memory.store_byte(NR_13, 0xC1);
+    memory.store_byte(NR_14, 0x87);
+    memory.store_byte(NR_12, 0xF3);
+    memory.store_byte(NR_51, 0xF3);
+    memory.store_byte(NR_50, 0x77);
+    memory.store_byte(BGP, 0xFC);
+
+    // the lcd starts its frame when it is turned on
+    _scheduler.advance(boot_lcd_off_cycles);
+    memory.store_byte(LCDC, 0x91);
+    _scheduler.advance(boot_lcd_cycle);
+
+    cpu::cpu& cpu = _system.cpu();
+    cpu.AF.store(0x01B0);
+    cpu.BC.store(0x0013);
+    cpu.DE.store(0x00D8);
+    cpu.HL.store(0x014D);
+    cpu.SP.store(0xFFFE);
+    cpu.PC.store(0x0100);
+    memory.store_byte(ENABLE_BOOT_ROM, 0x01);
+}
+
 void runner::add_breakpoint(word address){
     _breakpoints.insert(address);
 }
@@ -24,17 +118,26 @@ void runner::run_until_break(){
     } while (_breakpoints.find(_system.cpu().PC.load()) == _breakpoints.end());
 }
 
-void runner::next(){
+byte runner::next(){
     const word old_pc = _system.cpu().PC.load();
     const word opcode_word = _system.memory().load_word(old_pc);
-    gamekid::cpu::opcode* opcode = _decoder.decode(opcode_word);
+    const gamekid::cpu::opcode* opcode = _decoder.decode(opcode_word);
 
     if (opcode == nullptr) {
         throw std::exception("InvalidOpcode");
     }
 
     _system.cpu().PC.store(old_pc + opcode->full_size());
-    opcode->run();
+    _system.run_scheduled_operations();
+    opcode->run(_system.cpu());
+
+    // the lcd, the apu and the timer only run when they are observed or their event is due
+    _scheduler.advance(opcode->cycles);
+    return opcode->cycles;
+}
+
+void runner::request_interrupt(byte interrupt) {
+    _system.memory().store_byte(IF, _system.memory().load_byte(IF) | interrupt);
 }
 
 void runner::run(){
@@ -43,18 +146,261 @@ void runner::run(){
     }
 }
 
+void runner::take_input() {
+    _scheduler.joypad_sync().sync();
+    _joypad.drain(_lcd.frame_count());
+    _scheduler.joypad_sync().reschedule();
+}
+
+bool runner::run_frame() {
+    take_input();
+
+    if (!run_to_frame_end()) {
+        return false;
+    }
+
+    if (_rewind) {
+        save(_rewind_image);
+        _rewind->push(_rewind_image);
+    }
+
+    return true;
+}
+
+bool runner::run_to_frame_end() {
+    const dword frame = _lcd.frame_count();
+    dword cycles = 0;
+
+    // a frame's worth of cycles also ends the frame when the lcd is off
+    while (_lcd.frame_count() == frame && cycles < io::video::lcd_timing::cycles_per_frame) {
+        cycles += next();
+
+        if (_breakpoints.find(_system.cpu().PC.load()) != _breakpoints.end()) {
+            _scheduler.sync_all();
+            return false;
+        }
+    }
+
+    _scheduler.sync_all();
+    return true;
+}
+
+bool runner::run_cycles(dword cycles) {
+    take_input();
+    const std::uint64_t end = _scheduler.cycle() + cycles;
+
+    while (_scheduler.cycle() < end) {
+        next();
+
+        if (_breakpoints.find(_system.cpu().PC.load()) != _breakpoints.end()) {
+            _scheduler.sync_all();
+            return false;
+        }
+    }
+
+    _scheduler.sync_all();
+    return true;
+}
+
+bool runner::run_frame_ahead(dword frames) {
+    if (frames == 0) {
+        return run_frame();
+    }
+
+    // only the last frame ahead is drawn
+    _lcd.draw(false);
+
+    if (!run_frame()) {
+        _lcd.draw(true);
+        return false;
+    }
+
+    using clock = std::chrono::steady_clock;
+    const clock::time_point start = clock::now();
+    const size_t samples = _apu.samples().size();
+    save(_ahead);
+
+    const clock::time_point saved = clock::now();
+
+    // the queued input is left for the next frame, the frames ahead are restored
+    for (dword frame = 1; frame <= frames; ++frame) {
+        _lcd.draw(frame == frames);
+        run_to_frame_end();
+    }
+
+    const clock::time_point ran = clock::now();
+    load(_ahead);
+    _apu.discard_samples(samples);
+
+    const clock::time_point end = clock::now();
+    const double frame_us = 1e6 * io::video::lcd_timing::cycles_per_frame / io::video::lcd_timing::cycles_per_second;
+
+    _ahead_cost.snapshot_us = std::chrono::duration<double, std::micro>((saved - start) + (end - ran)).count();
+    _ahead_cost.ahead_us = std::chrono::duration<double, std::micro>(ran - saved).count();
+    _ahead_cost.frame_budget_percent = 100 * (_ahead_cost.snapshot_us + _ahead_cost.ahead_us) / frame_us;
+    return true;
+}
+
+const run_ahead_cost& runner::ahead_cost() const {
+    return _ahead_cost;
+}
+
+void runner::rewind(size_t budget, dword keyframe_interval) {
+    if (budget == 0) {
+        _rewind.reset();
+    } else {
+        _rewind = std::make_unique<state::rewind_buffer>(budget, keyframe_interval);
+    }
+}
+
+const state::rewind_buffer* runner::rewind_buffer() const {
+    return _rewind.get();
+}
+
+bool runner::step_back() {
+    // the newest state is the current one
+    if (!_rewind || _rewind->frames() < 2) {
+        return false;
+    }
+
+    _rewind->pop();
+    _rewind->latest(_rewind_image);
+    load(_rewind_image);
+    return true;
+}
+
+std::unique_ptr<runner> runner::fork() {
+    // the image is only needed while the child loads it, neither of them keeps it
+    state::snapshot image;
+    save(image);
+
+    // the rom, the ram and the video memory are shared, the memory that loads the same stays shared
+    auto child = std::make_unique<runner>(rom::cartridge(_cart));
+    child->_memory_map.share(_memory_map);
+    child->_lcd.share(_lcd);
+    child->load(image);
+    child->_breakpoints = _breakpoints;
+    return child;
+}
+
+bool runner::warm_start(const state::warm_cache& cache, dword frames, const std::string& configuration) {
+    if (_lcd.frame_count() != 0) {
+        throw std::exception("A warm start is the first run of a runner");
+    }
+
+    // the run is the same when it starts from the same state. The images don't keep the render mode, the
+    // backend or the synthesis mode, the runner keeps its own when an entry is loaded
+    state::snapshot image;
+    save(image);
+
+    state::warm_cache::key key{};
+    key.rom = utils::bytes::hash(_cart.data().data(), _cart.data().size());
+    key.run = utils::bytes::hash(image.data(), image.size());
+    key.run = utils::bytes::hash(&frames, sizeof(frames), key.run);
+    key.run = utils::bytes::hash(configuration.data(), configuration.size(), key.run);
+
+    if (cache.find(key, image)) {
+        load(image);
+        return true;
+    }
+
+    for (dword frame = 0; frame < frames; ++frame) {
+        if (!run_frame()) {
+            return false;
+        }
+    }
+
+    save(image);
+    cache.store(key, image);
+    return false;
+}
+
+memory_report runner::memory_usage() const {
+    memory_report report{};
+    report.object = sizeof(runner);
+    report.ram_owned = _memory_map.owned_pages() * sizeof(memory::normal_page::block);
+    report.ram_shared = _memory_map.shared_pages() * sizeof(memory::normal_page::block);
+    report.rom = _cart.data().size();
+    report.instructions = cpu::instruction_set::shared().heap_size() + _decoder.heap_size();
+    report.buffers = _lcd.heap_size() + _apu.heap_size() + _joypad.heap_size() + _memory_map.heap_size();
+    report.states = _ahead.capacity() + _rewind_image.capacity();
+
+    if (_rewind) {
+        report.states += sizeof(state::rewind_buffer) + _rewind->budget();
+    }
+
+    return report;
+}
+
+void runner::save(state::snapshot& snapshot) {
+    _scheduler.sync_all();
+    snapshot.clear();
+
+    snapshot.begin_section(state::make_tag("SYST"));
+    _system.save(snapshot);
+    snapshot.end_section();
+
+    snapshot.begin_section(state::make_tag("MEMO"));
+    _memory_map.save(snapshot);
+    snapshot.end_section();
+
+    _scheduler.save(snapshot);
+}
+
+void runner::load(state::snapshot& snapshot) {
+    snapshot.rewind();
+
+    snapshot.open_section(state::make_tag("SYST"));
+    _system.load(snapshot);
+    snapshot.close_section();
+
+    snapshot.open_section(state::make_tag("MEMO"));
+    _memory_map.load(snapshot);
+    snapshot.close_section();
+
+    _scheduler.load(snapshot);
+}
+
 cpu::cpu& runner::cpu() {
     return _system.cpu();
 }
 
+io::video::lcd& runner::lcd() {
+    return _lcd;
+}
+
+io::audio::apu& runner::apu() {
+    return _apu;
+}
+
+io::timer& runner::timer() {
+    return _timer;
+}
+
+io::serial& runner::serial() {
+    return _serial;
+}
+
+io::joypad_input& runner::joypad() {
+    return _joypad;
+}
+
+io::scheduler& runner::scheduler() {
+    return _scheduler;
+}
+
 std::vector<byte> runner::dump(word address_to_view, word length_to_view) {
-    std::vector<byte> bytes(length_to_view);
+    std::vector<byte> bytes;
+    dump(address_to_view, length_to_view, bytes);
+    return bytes;
+}
+
+void runner::dump(word address_to_view, word length_to_view, std::vector<byte>& bytes) {
+    bytes.resize(length_to_view);
 
     for (int i = 0; i < length_to_view; ++i) {
         bytes[i] = _system.memory().load<byte>(address_to_view+i);
     }
-
-    return bytes;
 }
 
 void runner::delete_breakpoint(word breakpoint_address) {
@@ -76,7 +422,7 @@ std::vector<std::string> runner::list(word address, word count) {
     
     for (word i = 0; i < count; i++) {
         const word opcode_word = _system.memory().load_word(address);
-        gamekid::cpu::opcode* op = _decoder.decode(opcode_word);
+        const gamekid::cpu::opcode* op = _decoder.decode(opcode_word);
 
         // Write the address 
         opcodes[i] = utils::convert::to_hex(address) + "  ";
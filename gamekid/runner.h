@@ -3,24 +3,79 @@
 #include "cpu/cpu.h"
 #include "cpu/instruction_set.h"
 #include "cpu/opcode_decoder.h"
+#include "io/scheduler.h"
+#include "state/snapshot.h"
+#include "state/rewind_buffer.h"
+#include "state/warm_cache.h"
 #include <set>
 #include "gamekid.tests/test_rom_map.h"
 
 namespace gamekid {
+    // The work of the last frame which was run ahead
+    struct run_ahead_cost {
+        // saving and restoring the state, in microseconds
+        double snapshot_us;
+        // the frames ahead, in microseconds
+        double ahead_us;
+        // both, in percents of the time of a frame (59.7hz)
+        double frame_budget_percent;
+    };
+
+    // The memory held by one runner, in bytes
+    struct memory_report {
+        // the runner object, which holds the components
+        size_t object;
+        // the ram pages written since they were shared, and the ones still shared with other runners
+        size_t ram_owned;
+        size_t ram_shared;
+        // shared by the copies of the cartridge
+        size_t rom;
+        // the instruction set and the decoder table, shared by every runner
+        size_t instructions;
+        // the lcd, apu and joypad buffers, and the video memory which isn't shared with other runners
+        size_t buffers;
+        // the run ahead and rewind states
+        size_t states;
+
+        // what this runner alone holds, without the shared memory
+        size_t total() const {
+            return object + ram_owned + buffers + states;
+        }
+    };
 
     class runner {
     private:
         rom::cartridge _cart;
         io::video::lcd _lcd;
+        io::audio::apu _apu;
+        io::timer _timer;
+        io::serial _serial;
+        io::joypad_input _joypad;
+        io::scheduler _scheduler;
         std::unique_ptr<rom::rom_map> _rom_map;
         memory::gameboy_memory_map _memory_map;
         system _system;
-        cpu::instruction_set _set;
-        cpu::opcode_decoder _decoder;
+        // shared by every runner
+        const cpu::opcode_decoder& _decoder;
         std::set<word> _breakpoints;
+        state::snapshot _ahead;
+        run_ahead_cost _ahead_cost{};
+        std::unique_ptr<state::rewind_buffer> _rewind;
+        state::snapshot _rewind_image;
+
+        void request_interrupt(byte interrupt);
+        // the scheduled point in which the queued input is taken
+        void take_input();
+        bool run_to_frame_end();
     public:
         explicit runner(rom::cartridge&& rom);
 
+        // Puts the runner in the state the boot rom leaves when it jumps to the cartridge at 0x100:
+        // the registers, the logo in the video memory and the lcd and DIV at the same point, without the
+        // 2.3M instructions of the logo scroll. Only the internal state of the boot sound and the frame count differ.
+        // Called before anything runs
+        void skip_boot_rom();
+
         const std::set<word>& breakpoints() const {
             return _breakpoints;
         }
@@ -28,10 +83,49 @@ namespace gamekid {
         std::vector<std::string> list(word address, word count);
         void add_breakpoint(word address);
         void run_until_break();
-        void next();
+        byte next();
         void run();
+        // Runs until the lcd completes a frame, returns false if it stopped at a breakpoint.
+        // The lcd, the apu and the timer are caught up when it returns
+        bool run_frame();
+        // Runs for at least the given amount of cycles, returns false if it stopped at a breakpoint.
+        // The components are caught up when it returns
+        bool run_cycles(dword cycles);
+        // Runs a frame, and then the given amount of frames ahead of it with the same input 
+        // which are thrown away. The screen is the last frame ahead (the game's input lag is hidden),
+        // the state and the samples are of the frame that was run
+        bool run_frame_ahead(dword frames);
+        const run_ahead_cost& ahead_cost() const;
+        // Keeps the state of every frame that is run for stepping back, in the given amount of bytes
+        // with a whole state every keyframe_interval frames (a minute of a game fits in a few MB).
+        // A budget of 0 turns it off
+        void rewind(size_t budget, dword keyframe_interval = 60);
+        const state::rewind_buffer* rewind_buffer() const;
+        // Goes back to the state at the end of the previous frame, returns false if it isn't kept
+        bool step_back();
+        // An independent copy of the runner in its current state, which shares the rom, the ram pages and the
+        // video memory that neither of them wrote since. The rewind buffer and the input posted but not taken yet are not copied
+        std::unique_ptr<runner> fork();
+        // Runs the given amount of frames, or loads the state they end in from the cache when an earlier run
+        // from the same start stored it: the rom, the saved state it starts in and the configuration, which names
+        // what else changes the run (such as its input). Returns true if the state was loaded.
+        // It is the first run of the runner, an entry is stored when the frames are run without a breakpoint
+        bool warm_start(const state::warm_cache& cache, dword frames, const std::string& configuration = "");
+        memory_report memory_usage() const;
+        // The whole emulation state, the components are caught up before it is saved
+        void save(state::snapshot& snapshot);
+        void load(state::snapshot& snapshot);
         cpu::cpu& cpu();
+        io::video::lcd& lcd();
+        io::audio::apu& apu();
+        io::timer& timer();
+        io::serial& serial();
+        // Input can be posted from another thread
+        io::joypad_input& joypad();
+        io::scheduler& scheduler();
         std::vector<byte> dump(word address_to_view, word length_to_view);
+        // Into the given buffer, which keeps its capacity
+        void dump(word address_to_view, word length_to_view, std::vector<byte>& bytes);
         void delete_breakpoint(word breakpoint_address);
         void delete_all_breakpoints();
     };
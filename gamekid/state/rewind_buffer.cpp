@@ -0,0 +1,225 @@
+#include "rewind_buffer.h"
+#include <algorithm>
+#include <cstring>
+
+using gamekid::state::rewind_buffer;
+using gamekid::state::snapshot;
+
+namespace {
+    // a token is a run of zeros followed by literal bytes
+    const size_t max_run = 0xFFFF;
+    // shorter runs of zeros are cheaper as literals
+    const size_t min_zeros = 4;
+
+    // the base is zero padded when the image is longer
+    inline byte base_at(const snapshot* base, size_t index) {
+        return base != nullptr && index < base->size() ? base->data()[index] : 0;
+    }
+
+    void write_word(std::vector<byte>& out, size_t value) {
+        out.push_back(static_cast<byte>(value));
+        out.push_back(static_cast<byte>(value >> 8));
+    }
+
+    size_t read_word(const byte* data) {
+        return data[0] | (data[1] << 8);
+    }
+}
+
+rewind_buffer::rewind_buffer(size_t budget, dword keyframe_interval) :
+_memory(budget), _keyframe_interval(std::max<dword>(keyframe_interval, 1)) {
+}
+
+void rewind_buffer::encode(const snapshot& image, const snapshot* base, std::vector<byte>& out) {
+    const byte* data = image.data();
+    const size_t size = image.size();
+    out.clear();
+
+    const auto value = [&](size_t index) { return static_cast<byte>(data[index] ^ base_at(base, index)); };
+
+    const auto zeros_at = [&](size_t index) {
+        const size_t end = std::min(index + min_zeros, size);
+
+        for (size_t i = index; i < end; ++i) {
+            if (value(i) != 0) return false;
+        }
+
+        return true;
+    };
+
+    size_t index = 0;
+
+    while (index < size) {
+        size_t zeros = 0;
+
+        while (index + zeros < size && zeros < max_run && value(index + zeros) == 0) {
+            ++zeros;
+        }
+
+        index += zeros;
+        size_t literals = 0;
+
+        while (index + literals < size && literals < max_run && !zeros_at(index + literals)) {
+            ++literals;
+        }
+
+        write_word(out, zeros);
+        write_word(out, literals);
+
+        for (size_t i = 0; i < literals; ++i) {
+            out.push_back(value(index + i));
+        }
+
+        index += literals;
+    }
+}
+
+void rewind_buffer::decode(const byte* encoded, size_t length, size_t image_size, const snapshot* base, snapshot& out) {
+    out.resize(image_size);
+    byte* data = out.data();
+    const byte* end = encoded + length;
+    size_t index = 0;
+
+    while (encoded < end) {
+        const size_t zeros = read_word(encoded);
+        const size_t literals = read_word(encoded + 2);
+        encoded += 4;
+
+        for (size_t i = 0; i < zeros; ++i, ++index) {
+            data[index] = base_at(base, index);
+        }
+
+        for (size_t i = 0; i < literals; ++i, ++index) {
+            data[index] = encoded[i] ^ base_at(base, index);
+        }
+
+        encoded += literals;
+    }
+}
+
+bool rewind_buffer::store(bool keyframe, size_t image_size) {
+    const size_t length = _encoded.size();
+
+    if (length > _memory.size()) {
+        while (!_entries.empty()) drop_oldest();
+        return false;
+    }
+
+    size_t offset = _head;
+
+    // the tail of the memory is left and the entries in it (the oldest ones) are dropped
+    if (offset + length > _memory.size()) {
+        while (!_entries.empty() && _entries.front().offset >= _head) {
+            drop_oldest();
+        }
+
+        offset = 0;
+    }
+
+    while (!_entries.empty() && _entries.front().offset < offset + length &&
+        offset < _entries.front().offset + _entries.front().length) {
+        drop_oldest();
+    }
+
+    // the keyframe of the delta was dropped
+    if (!keyframe && _entries.empty()) {
+        return false;
+    }
+
+    std::memcpy(_memory.data() + offset, _encoded.data(), length);
+    _entries.push_back({ offset, length, image_size, keyframe });
+    _head = offset + length;
+    _used += length;
+    return true;
+}
+
+void rewind_buffer::drop_oldest() {
+    _used -= _entries.front().length;
+    _entries.pop_front();
+
+    // deltas are useless without their keyframe
+    while (!_entries.empty() && !_entries.front().keyframe) {
+        _used -= _entries.front().length;
+        _entries.pop_front();
+    }
+}
+
+void rewind_buffer::push_keyframe(const snapshot& image) {
+    encode(image, nullptr, _encoded);
+
+    if (store(true, image.size())) {
+        _keyframe.assign(image.data(), image.size());
+        _since_keyframe = 0;
+    }
+}
+
+void rewind_buffer::push(const snapshot& image) {
+    if (_entries.empty() || _since_keyframe + 1 >= _keyframe_interval) {
+        push_keyframe(image);
+        return;
+    }
+
+    encode(image, &_keyframe, _encoded);
+
+    if (store(false, image.size())) {
+        ++_since_keyframe;
+    } else {
+        push_keyframe(image);
+    }
+}
+
+bool rewind_buffer::pop() {
+    if (_entries.empty()) {
+        return false;
+    }
+
+    const entry newest = _entries.back();
+    _entries.pop_back();
+    _used -= newest.length;
+    _head = newest.offset;
+
+    if (!newest.keyframe) {
+        --_since_keyframe;
+        return true;
+    }
+
+    // the deltas before it are made from the previous keyframe
+    _since_keyframe = 0;
+
+    for (auto previous = _entries.rbegin(); previous != _entries.rend(); ++previous) {
+        if (previous->keyframe) {
+            decode(_memory.data() + previous->offset, previous->length, previous->image_size, nullptr, _keyframe);
+            break;
+        }
+
+        ++_since_keyframe;
+    }
+
+    return true;
+}
+
+bool rewind_buffer::latest(snapshot& out) {
+    if (_entries.empty()) {
+        return false;
+    }
+
+    const entry& newest = _entries.back();
+    decode(_memory.data() + newest.offset, newest.length, newest.image_size, newest.keyframe ? nullptr : &_keyframe, out);
+    return true;
+}
+
+size_t rewind_buffer::frames() const {
+    return _entries.size();
+}
+
+size_t rewind_buffer::used() const {
+    return _used;
+}
+
+size_t rewind_buffer::budget() const {
+    return _memory.size();
+}
+
+dword rewind_buffer::keyframe_interval() const {
+    return _keyframe_interval;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "snapshot.h"
+#include <deque>
+#include <vector>
+
+namespace gamekid::state {
+
+    // The states of the last frames in a fixed amount of memory.
+    // Every keyframe_interval frames a whole image (a keyframe) is kept, the frames between keep only the
+    // bytes that differ from their keyframe (xor). Both are run length encoded, most of an image is zeros
+    // and most of a delta is unchanged. When the memory is full the oldest keyframe and its deltas are dropped
+    class rewind_buffer {
+    private:
+        struct entry {
+            size_t offset;
+            size_t length;
+            size_t image_size;
+            bool keyframe;
+        };
+
+        std::vector<byte> _memory;
+        std::deque<entry> _entries;
+        // where the next entry is written, entries are contiguous and wrap to the start of the memory
+        size_t _head = 0;
+        size_t _used = 0;
+        dword _keyframe_interval;
+        // the deltas after the newest keyframe
+        dword _since_keyframe = 0;
+
+        // the newest keyframe, the deltas are made from it
+        snapshot _keyframe;
+        std::vector<byte> _encoded;
+
+        static void encode(const snapshot& image, const snapshot* base, std::vector<byte>& out);
+        static void decode(const byte* encoded, size_t length, size_t image_size, const snapshot* base, snapshot& out);
+        bool store(bool keyframe, size_t image_size);
+        void drop_oldest();
+        void push_keyframe(const snapshot& image);
+    public:
+        rewind_buffer(size_t budget, dword keyframe_interval);
+
+        rewind_buffer(const rewind_buffer&) = delete;
+        rewind_buffer& operator=(const rewind_buffer&) = delete;
+
+        // Keeps the image of the frame
+        void push(const snapshot& image);
+
+        // Drops the newest image, returns false if there was none
+        bool pop();
+
+        // The newest image, returns false if there is none
+        bool latest(snapshot& out);
+
+        // The amount of frames kept
+        size_t frames() const;
+
+        // The bytes used by the kept frames
+        size_t used() const;
+
+        size_t budget() const;
+        dword keyframe_interval() const;
+    };
+}
@@ -0,0 +1,145 @@
+#include "snapshot.h"
+#include <gamekid/utils/files.h>
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+using gamekid::state::snapshot;
+
+namespace {
+    // the magic and the version
+    const size_t header_size = sizeof(gamekid::state::tag) + sizeof(std::uint32_t);
+}
+
+snapshot::snapshot(size_t capacity) : _buffer(capacity) {
+}
+
+void snapshot::clear() {
+    _size = 0;
+    _position = 0;
+    write(magic, version);
+}
+
+void snapshot::rewind() {
+    _position = 0;
+
+    tag image_magic;
+    std::uint32_t image_version;
+    read(image_magic, image_version);
+
+    if (image_magic != magic) {
+        throw std::exception("Not a saved state");
+    }
+
+    if (image_version != version) {
+        throw std::exception("Unsupported saved state version");
+    }
+}
+
+void snapshot::resize(size_t size) {
+    if (size > _buffer.size()) {
+        _buffer.resize(size);
+    }
+
+    _size = size;
+    _position = 0;
+}
+
+void snapshot::assign(const byte* data, size_t size) {
+    resize(size);
+    std::memcpy(_buffer.data(), data, size);
+}
+
+void snapshot::begin_section(tag name) {
+    write(name, std::uint32_t(0));
+    _section = _size - sizeof(std::uint32_t);
+}
+
+void snapshot::end_section() {
+    const auto size = static_cast<std::uint32_t>(_size - _section - sizeof(std::uint32_t));
+    std::memcpy(_buffer.data() + _section, &size, sizeof(size));
+}
+
+void snapshot::open_section(tag name) {
+    _position = header_size;
+
+    while (_position < _size) {
+        tag section_name;
+        std::uint32_t size;
+        read(section_name, size);
+
+        if (_position + size > _size) {
+            throw std::exception("Saved state is truncated");
+        }
+
+        if (section_name == name) {
+            _section = _position + size;
+            return;
+        }
+
+        _position += size;
+    }
+
+    throw std::exception("Saved state has a missing section");
+}
+
+void snapshot::close_section() {
+    if (_position != _section) {
+        throw std::exception("Saved state has a section of a wrong size");
+    }
+}
+
+void snapshot::save_file(const std::string& file_name) const {
+    utils::files::write_file(file_name, _buffer.data(), _size);
+}
+
+void snapshot::load_file(const std::string& file_name) {
+    _buffer = utils::files::read_file(file_name);
+    _size = _buffer.size();
+    rewind();
+}
+
+void snapshot::write_block(const void* data, size_t size) {
+    if (_size + size > _buffer.size()) {
+        _buffer.resize(std::max(_size + size, _buffer.size() * 2));
+    }
+
+    std::memcpy(_buffer.data() + _size, data, size);
+    _size += size;
+}
+
+void snapshot::read_block(void* data, size_t size) {
+    if (_position + size > _size) {
+        throw std::exception("Snapshot is too short");
+    }
+
+    std::memcpy(data, _buffer.data() + _position, size);
+    _position += size;
+}
+
+void snapshot::read_value(bool& value) {
+    byte raw;
+    read_block(&raw, sizeof(raw));
+
+    if (raw > 1) {
+        invalid_value();
+    }
+
+    value = raw != 0;
+}
+
+void snapshot::check_below(std::uint64_t value, std::uint64_t limit) {
+    if (value >= limit) {
+        invalid_value();
+    }
+}
+
+void snapshot::invalid_value() {
+    throw std::exception("Saved state has an invalid value");
+}
+
+void snapshot::check_count(std::uint32_t count, size_t item_size) const {
+    if (count > (_size - _position) / item_size) {
+        throw std::exception("Snapshot is too short");
+    }
+}
@@ -0,0 +1,179 @@
+#pragma once
+#include <gamekid/utils/types.h>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace gamekid::state {
+    using tag = std::uint32_t;
+
+    // 4 characters, the first one in the lowest byte
+    constexpr tag make_tag(const char (&name)[5]) {
+        return static_cast<tag>(static_cast<byte>(name[0])) | static_cast<tag>(static_cast<byte>(name[1])) << 8 |
+            static_cast<tag>(static_cast<byte>(name[2])) << 16 | static_cast<tag>(static_cast<byte>(name[3])) << 24;
+    }
+
+    // A value which is copied as a block: every byte of it is a part of its value, there is no padding
+    // between its fields. So the same state is always the same image
+    template <typename T>
+    struct is_block : std::bool_constant<std::is_trivially_copyable_v<T> &&
+        (std::has_unique_object_representations_v<T> || std::is_same_v<T, bool>)> {};
+
+    template <typename T, size_t N>
+    struct is_block<std::array<T, N>> : is_block<T> {};
+
+    template <typename T>
+    constexpr bool is_block_v = is_block<T>::value;
+
+    // The state of the emulation as a flat binary image.
+    // Components write their state with block copies and read it back in the same order,
+    // records with padding between their fields are written field by field.
+    // The buffer keeps its capacity, so writing into a snapshot which already held one doesn't allocate.
+    //
+    // The image starts with a magic and a format version, followed by tagged sections:
+    // a tag, the size of the section and the section itself (little endian, the host's layout of the fields).
+    // Sections are found by their tag, the ones which are unknown to the reader are skipped
+    class snapshot {
+    private:
+        std::vector<byte> _buffer;
+        size_t _size = 0;
+        size_t _position = 0;
+        // the size field of the section that is written, or the end of the section that is read
+        size_t _section = 0;
+
+        template <typename T>
+        void read_value(T& value) {
+            read_block(&value, sizeof(T));
+        }
+
+        // an image which is not trusted may hold any byte
+        void read_value(bool& value);
+        [[noreturn]] static void invalid_value();
+        // throws if the image has fewer bytes left than count items of the given size
+        void check_count(std::uint32_t count, size_t item_size) const;
+    public:
+        static constexpr tag magic = make_tag("GKST");
+        // Bumped whenever the layout of a section changes, images of other versions are not read
+        static constexpr std::uint32_t version = 5;
+
+        explicit snapshot(size_t capacity = 0);
+
+        // Starts writing a new image (the capacity is kept)
+        void clear();
+
+        // Starts reading the image from its beginning, throws if it is not an image of this version
+        void rewind();
+
+        // Writes a section, sections are not nested
+        void begin_section(tag name);
+        void end_section();
+
+        // Reads a section, throws if the image has no such section or it wasn't read to its end
+        void open_section(tag name);
+        void close_section();
+
+        // The image as a file
+        void save_file(const std::string& file_name) const;
+        void load_file(const std::string& file_name);
+
+        void write_block(const void* data, size_t size);
+        void read_block(void* data, size_t size);
+
+        template <typename... T>
+        void write(const T&... values) {
+            static_assert((is_block_v<T> && ...), "only values without padding are copied as a block");
+            (write_block(&values, sizeof(T)), ...);
+        }
+
+        // A bool is checked to be 0 or 1, enums are read with read_enum
+        template <typename... T>
+        void read(T&... values) {
+            static_assert((is_block_v<T> && ...), "only values without padding are copied as a block");
+            static_assert(!(std::is_enum_v<T> || ...), "enums are read with read_enum");
+            (read_value(values), ...);
+        }
+
+        // Throws if the image holds a value after the last one of the enum
+        template <typename Enum>
+        void read_enum(Enum& value, Enum last) {
+            using underlying = std::underlying_type_t<Enum>;
+            underlying raw;
+            read(raw);
+
+            if (static_cast<std::make_unsigned_t<underlying>>(raw) > static_cast<std::make_unsigned_t<underlying>>(last)) {
+                invalid_value();
+            }
+
+            value = static_cast<Enum>(raw);
+        }
+
+        // Throws if a value which was read is not below the limit, for the values which index a table
+        // or are used as a shift
+        static void check_below(std::uint64_t value, std::uint64_t limit);
+
+        template <typename T>
+        void write_vector(const std::vector<T>& values) {
+            static_assert(is_block_v<T>, "records with padding are written with a function for their fields");
+            write(static_cast<std::uint32_t>(values.size()));
+            write_block(values.data(), values.size() * sizeof(T));
+        }
+
+        // The vector doesn't allocate when its capacity is large enough
+        template <typename T>
+        void read_vector(std::vector<T>& values) {
+            static_assert(is_block_v<T> && !std::is_same_v<T, bool> && !std::is_enum_v<T>,
+                "records with padding, bools and enums are read with a function for their fields");
+            std::uint32_t size;
+            read(size);
+            check_count(size, sizeof(T));
+            values.resize(size);
+            read_block(values.data(), size * sizeof(T));
+        }
+
+        // Writes every record with write_record(snapshot, record), which writes its fields
+        template <typename T, typename Write>
+        void write_vector(const std::vector<T>& values, Write write_record) {
+            write(static_cast<std::uint32_t>(values.size()));
+
+            for (const T& value : values) {
+                write_record(*this, value);
+            }
+        }
+
+        // Reads every record with read_record(snapshot, record), which reads its fields
+        template <typename T, typename Read>
+        void read_vector(std::vector<T>& values, Read read_record) {
+            std::uint32_t size;
+            read(size);
+            check_count(size, 1);
+            values.resize(size);
+
+            for (T& value : values) {
+                read_record(*this, value);
+            }
+        }
+
+        const byte* data() const {
+            return _buffer.data();
+        }
+
+        // The image as raw bytes, to keep it elsewhere
+        byte* data() {
+            return _buffer.data();
+        }
+
+        // Sets the size of the image, for filling it with raw bytes
+        void resize(size_t size);
+        void assign(const byte* data, size_t size);
+
+        size_t size() const {
+            return _size;
+        }
+
+        size_t capacity() const {
+            return _buffer.size();
+        }
+    };
+}
@@ -0,0 +1,78 @@
+#include "warm_cache.h"
+#include <gamekid/utils/convert.h>
+#include <gamekid/utils/files.h>
+#include <cstring>
+#include <filesystem>
+
+using gamekid::state::warm_cache;
+
+namespace {
+    struct entry_header {
+        gamekid::state::tag magic;
+        std::uint32_t core_version;
+        warm_cache::key key;
+    };
+
+    std::string to_hex(std::uint64_t value) {
+        using gamekid::utils::convert::to_hex;
+        return to_hex(static_cast<dword>(value >> 32)) + to_hex(static_cast<dword>(value));
+    }
+}
+
+warm_cache::warm_cache(const std::string& directory) : _directory(directory) {
+    std::error_code error;
+    std::filesystem::create_directories(_directory, error);
+
+    if (error) {
+        throw std::exception("Cannot create the cache directory");
+    }
+}
+
+std::string warm_cache::path(const key& key) const {
+    return (std::filesystem::path(_directory) / (to_hex(key.rom) + "-" + to_hex(key.run) + ".warm")).string();
+}
+
+bool warm_cache::find(const key& key, snapshot& snapshot) const {
+    const std::string file_name = path(key);
+
+    if (!std::filesystem::exists(file_name)) {
+        return false;
+    }
+
+    try {
+        const utils::files::mapped_file file(file_name);
+        entry_header header;
+
+        if (file.size() < sizeof(header)) {
+            return false;
+        }
+
+        std::memcpy(&header, file.data(), sizeof(header));
+
+        if (header.magic != magic || header.core_version != core_version ||
+            header.key.rom != key.rom || header.key.run != key.run) {
+            return false;
+        }
+
+        snapshot.assign(file.data() + sizeof(header), file.size() - sizeof(header));
+        snapshot.rewind();
+        return true;
+    } catch (const std::exception&) {
+        // an entry of another snapshot version, or one which was replaced while it was opened
+        return false;
+    }
+}
+
+bool warm_cache::store(const key& key, const snapshot& snapshot) const {
+    const entry_header header{ magic, core_version, key };
+    std::vector<byte> entry(sizeof(header) + snapshot.size());
+    std::memcpy(entry.data(), &header, sizeof(header));
+    std::memcpy(entry.data() + sizeof(header), snapshot.data(), snapshot.size());
+
+    try {
+        utils::files::write_file_atomic(path(key), entry.data(), entry.size());
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "snapshot.h"
+#include <cstdint>
+#include <string>
+
+namespace gamekid::state {
+    // The states that runs reach a number of frames after their start, kept as files of a directory,
+    // so later runs from the same start load them instead of running the frames again (a game's intro and menus).
+    // The processes which share the directory see whole entries, an entry is written next to its file and renamed over it.
+    //
+    // An entry is named after the hash of the rom and the hash of the rest of the key, and starts with
+    // a header of the magic, the core version and the key
+    class warm_cache {
+    private:
+        std::string _directory;
+    public:
+        static constexpr tag magic = make_tag("GKWC");
+        // Bumped whenever a change of the emulation changes the state the same frames end in,
+        // the entries of other versions are run again and replaced
+        static constexpr std::uint32_t core_version = 1;
+
+        struct key {
+            std::uint64_t rom;
+            // the start state, the frames and the configuration of the run
+            std::uint64_t run;
+        };
+
+        // The directory is created if it doesn't exist
+        explicit warm_cache(const std::string& directory);
+
+        std::string path(const key& key) const;
+
+        // Copies the state of the entry into the snapshot, returns false if there is no entry of this core
+        // (and snapshot) version
+        bool find(const key& key, snapshot& snapshot) const;
+
+        // Returns false if the entry couldn't be written, the run goes on without it
+        bool store(const key& key, const snapshot& snapshot) const;
+    };
+}
@@ -1,6 +1,47 @@
 #include "system.h"
+#include "state/snapshot.h"
+#include <algorithm>
 
-void gamekid::system::schedule_operation(system_operation<> operation, 
-    int instruction_count) {
-    _scheduled_operations.emplace_back(operation, instruction_count);
+void gamekid::system::schedule_operation(scheduled_action action, int instruction_count) {
+    _scheduled_operations.push_back({ action, instruction_count });
+}
+
+void gamekid::system::run_scheduled_operations() {
+    if (_scheduled_operations.empty()) {
+        return;
+    }
+
+    for (scheduled_operation& operation : _scheduled_operations) {
+        if (--operation.instruction_count > 0) {
+            continue;
+        }
+
+        switch (operation.action) {
+        case scheduled_action::enable_interrupts:
+            _cpu.enable_interrupts();
+            break;
+        case scheduled_action::disable_interrupts:
+            _cpu.disable_interrupts();
+            break;
+        }
+    }
+
+    _scheduled_operations.erase(std::remove_if(_scheduled_operations.begin(), _scheduled_operations.end(),
+        [](const scheduled_operation& operation) { return operation.instruction_count <= 0; }),
+        _scheduled_operations.end());
+}
+
+void gamekid::system::save(state::snapshot& snapshot) const {
+    _cpu.save(snapshot);
+    snapshot.write_vector(_scheduled_operations, [](state::snapshot& image, const scheduled_operation& operation) {
+        image.write(operation.action, operation.instruction_count);
+    });
+}
+
+void gamekid::system::load(state::snapshot& snapshot) {
+    _cpu.load(snapshot);
+    snapshot.read_vector(_scheduled_operations, [](state::snapshot& image, scheduled_operation& operation) {
+        image.read_enum(operation.action, scheduled_action::disable_interrupts);
+        image.read(operation.instruction_count);
+    });
 }
@@ -6,6 +6,10 @@
 #include "memory/gameboy_memory_map.h"
 #include "memory/error_memory_map.h"
 
+namespace gamekid::state {
+    class snapshot;
+}
+
 namespace gamekid {
     namespace cpu {
         class cpu;
@@ -16,15 +20,17 @@ namespace gamekid {
 
     class system;
 
-    template <typename... operand_types>
-    using system_operation = std::function<void(system&, cpu::operand<operand_types>&...)>;
+    // The operations which take effect some instructions after the one that scheduled them.
+    // They are plain values so the pending ones are saved with the state
+    enum class scheduled_action : byte {
+        enable_interrupts,
+        disable_interrupts
+    };
 
     struct scheduled_operation {
-        system_operation<> operation;
+        scheduled_action action;
+        // the instructions left before it takes effect
         int instruction_count;
-
-        scheduled_operation(system_operation<> operation, int instruction_count) :
-            operation(operation), instruction_count(instruction_count) {}
     };
 
 
@@ -54,6 +60,14 @@ namespace gamekid {
             return _memory;
         }
 
-        void schedule_operation(system_operation<> operation, int instruction_count);
+        void schedule_operation(scheduled_action action, int instruction_count);
+
+        // Counts down the scheduled operations before an instruction runs,
+        // an operation with a count of 1 takes effect before the instruction that follows the one which scheduled it
+        void run_scheduled_operations();
+
+        // The cpu and the pending operations
+        void save(state::snapshot& snapshot) const;
+        void load(state::snapshot& snapshot);
     };
 }
@@ -11,4 +11,14 @@ std::vector<byte> bytes::little_endian_encode(int value, int size_in_bytes) {
     }
 
     return value_in_bytes;
-}
\ No newline at end of file
+}
+std::uint64_t bytes::hash(const void* data, size_t size, std::uint64_t seed) {
+    const byte* current = static_cast<const byte*>(data);
+    std::uint64_t result = seed;
+
+    for (size_t index = 0; index < size; ++index) {
+        result = (result ^ current[index]) * 0x100000001B3;
+    }
+
+    return result;
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <gamekid/utils/types.h>
 #include <algorithm>
@@ -7,6 +8,10 @@
 namespace gamekid::utils::bytes {
     std::vector<byte> little_endian_encode(int value, int size_in_bytes);
 
+    // FNV-1a of the bytes, for naming and comparing contents (not against a deliberate collision).
+    // The hash of a few blocks is the hash of each one seeded with the hash of the ones before it
+    std::uint64_t hash(const void* data, size_t size, std::uint64_t seed = 0xCBF29CE484222325);
+
     template <typename T>
     std::vector<byte> little_endian_encode(T value) {
         return little_endian_encode(value, sizeof(T));
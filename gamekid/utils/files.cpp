@@ -1,5 +1,21 @@
 #include "files.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using gamekid::utils::files::mapped_file;
 
 std::vector<byte> gamekid::utils::files::read_file(const std::string & fileName) {
     std::ifstream f(fileName, std::ios::binary | std::ios::in | std::ios::ate);
@@ -15,3 +31,123 @@ std::vector<byte> gamekid::utils::files::read_file(const std::string & fileName)
     return data;
 }
 
+
+void gamekid::utils::files::write_file(const std::string& fileName, const byte* data, size_t size) {
+    std::ofstream f(fileName, std::ios::binary | std::ios::out | std::ios::trunc);
+
+    if (!f.is_open()) {
+        throw std::exception("Error Opening File");
+    }
+
+    f.write(reinterpret_cast<const char*>(data), size);
+}
+
+void gamekid::utils::files::write_file_atomic(const std::string& fileName, const byte* data, size_t size) {
+    // unique among the threads and the processes which write the same file
+    static std::atomic<dword> counter{ 0 };
+    const size_t unique = std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+        static_cast<size_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^ ++counter;
+    const std::string temporary = fileName + "." + std::to_string(unique) + ".tmp";
+
+    {
+        std::ofstream f(temporary, std::ios::binary | std::ios::out | std::ios::trunc);
+
+        if (!f.is_open()) {
+            throw std::exception("Error Opening File");
+        }
+
+        f.write(reinterpret_cast<const char*>(data), size);
+
+        if (!f.flush()) {
+            f.close();
+            std::filesystem::remove(temporary);
+            throw std::exception("Error Writing File");
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, fileName, error);
+
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        throw std::exception("Error Replacing File");
+    }
+}
+
+#ifdef _WIN32
+mapped_file::mapped_file(const std::string& fileName) {
+    const HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::exception("Error Opening File");
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::exception("Error Opening File");
+    }
+
+    _size = static_cast<size_t>(size.QuadPart);
+
+    // an empty file cannot be mapped
+    if (_size != 0) {
+        const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        // the view keeps the file and the mapping open
+        if (mapping != nullptr) {
+            _data = static_cast<const byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(mapping);
+        }
+    }
+
+    CloseHandle(file);
+
+    if (_size != 0 && _data == nullptr) {
+        throw std::exception("Error Mapping File");
+    }
+}
+
+mapped_file::~mapped_file() {
+    if (_data != nullptr) {
+        UnmapViewOfFile(_data);
+    }
+}
+#else
+mapped_file::mapped_file(const std::string& fileName) {
+    const int file = ::open(fileName.c_str(), O_RDONLY);
+
+    if (file < 0) {
+        throw std::exception("Error Opening File");
+    }
+
+    struct stat status;
+
+    if (::fstat(file, &status) != 0) {
+        ::close(file);
+        throw std::exception("Error Opening File");
+    }
+
+    _size = static_cast<size_t>(status.st_size);
+
+    // an empty file cannot be mapped, the mapping keeps the file open
+    if (_size != 0) {
+        void* data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+        _data = data == MAP_FAILED ? nullptr : static_cast<const byte*>(data);
+    }
+
+    ::close(file);
+
+    if (_size != 0 && _data == nullptr) {
+        throw std::exception("Error Mapping File");
+    }
+}
+
+mapped_file::~mapped_file() {
+    if (_data != nullptr) {
+        ::munmap(const_cast<byte*>(_data), _size);
+    }
+}
+#endif
@@ -1,7 +1,35 @@
 #pragma once
+#include <string>
 #include <vector>
 #include <gamekid/utils/types.h>
 
 namespace gamekid::utils::files {
     std::vector<byte> read_file(const std::string& fileName);
-}
\ No newline at end of file
+    void write_file(const std::string& fileName, const byte* data, size_t size);
+
+    // Writes a temporary file next to the file and renames it over it,
+    // so a reader (of another process too) sees the old file or the whole new one
+    void write_file_atomic(const std::string& fileName, const byte* data, size_t size);
+
+    // A read only view of a whole file, its pages are read when they are touched
+    class mapped_file {
+    private:
+        const byte* _data = nullptr;
+        size_t _size = 0;
+    public:
+        // Throws if the file cannot be opened
+        explicit mapped_file(const std::string& fileName);
+        ~mapped_file();
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        const byte* data() const {
+            return _data;
+        }
+
+        size_t size() const {
+            return _size;
+        }
+    };
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace gamekid::utils {
+
+    // A wait-free ring buffer between exactly one producer thread and one consumer thread.
+    // The producer only writes _head and the consumer only writes _tail, so neither side
+    // ever waits for the other: a full ring takes fewer items and an empty ring returns fewer.
+    template <typename T>
+    class spsc_ring {
+    private:
+        std::vector<T> _items;
+        size_t _mask;
+
+        // both counters only grow, the index in the ring is the counter & _mask.
+        // they are on separate cache lines so the two threads don't fight over one
+        alignas(64) std::atomic<size_t> _head{ 0 };
+        alignas(64) std::atomic<size_t> _tail{ 0 };
+
+        static size_t round_capacity(size_t capacity) {
+            size_t result = 1;
+            while (result < capacity) result <<= 1;
+            return result;
+        }
+    public:
+        // The capacity is rounded up to a power of 2
+        explicit spsc_ring(size_t capacity) : _items(round_capacity(capacity)), _mask(_items.size() - 1) {
+        }
+
+        spsc_ring(const spsc_ring&) = delete;
+        spsc_ring& operator=(const spsc_ring&) = delete;
+
+        size_t capacity() const {
+            return _items.size();
+        }
+
+        // The fill level, exact on either thread for its own side and a snapshot otherwise
+        size_t size() const {
+            return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+        }
+
+        // Producer: copies as many items as fit and returns how many were copied
+        size_t write(const T* items, size_t count) {
+            const size_t head = _head.load(std::memory_order_relaxed);
+            const size_t tail = _tail.load(std::memory_order_acquire);
+            count = std::min(count, capacity() - (head - tail));
+
+            // the items may wrap around the end of the ring
+            const size_t first = std::min(count, capacity() - (head & _mask));
+            std::copy(items, items + first, _items.begin() + (head & _mask));
+            std::copy(items + first, items + count, _items.begin());
+
+            _head.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+        // Consumer: copies up to count items out and returns how many were copied
+        size_t read(T* out, size_t count) {
+            const size_t tail = _tail.load(std::memory_order_relaxed);
+            const size_t head = _head.load(std::memory_order_acquire);
+            count = std::min(count, head - tail);
+
+            const size_t first = std::min(count, capacity() - (tail & _mask));
+            std::copy(_items.begin() + (tail & _mask), _items.begin() + (tail & _mask) + first, out);
+            std::copy(_items.begin(), _items.begin() + (count - first), out + first);
+
+            _tail.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        bool push(const T& item) {
+            return write(&item, 1) == 1;
+        }
+
+        bool pop(T& item) {
+            return read(&item, 1) == 1;
+        }
+    };
+}